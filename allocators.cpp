@@ -0,0 +1,200 @@
+#include "allocators.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+LinearArena::LinearArena(size_t capacity)
+    : _buffer(static_cast<unsigned char*>(std::malloc(capacity))),
+      _capacity(capacity)
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+LinearArena::~LinearArena()
+{
+    Reset();
+    std::free(_buffer);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+    size_t offset = (_offset + alignment - 1) & ~(alignment - 1);
+    if ( offset + size <= _capacity )
+    {
+        _offset = offset;
+        void* ptr = _buffer + _offset;
+        _offset += size;
+        return ptr;
+    }
+
+    // out of space, keep working but remember how much we lacked so the
+    // caller can size the arena properly
+    _overflowBytes += size;
+    void* ptr = std::malloc(size + alignment);
+    _overflow.push_back(ptr);
+    uintptr_t aligned = ((uintptr_t)ptr + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    return (void*)aligned;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LinearArena::Reset()
+{
+    for ( void* ptr : _overflow )
+        std::free(ptr);
+
+    _overflow.clear();
+    _overflowBytes = 0;
+    _offset = 0;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+FrameArena& FrameArena::Get()
+{
+    static FrameArena instance;
+    return instance;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+FrameArena::FrameArena()
+{
+    _arenas[0] = std::make_unique<LinearArena>(s_capacity);
+    _arenas[1] = std::make_unique<LinearArena>(s_capacity);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void FrameArena::BeginFrame()
+{
+    LinearArena& previous = GetCurrent();
+    _highWaterMark = std::max(_highWaterMark, previous.GetUsed() + previous.GetOverflowBytes());
+
+    _current ^= 1u;
+    GetCurrent().Reset();
+}
+
+static size_t s_frameStartCount = 0;
+static size_t s_lastFrameCount  = 0;
+static size_t s_zeroFrameStreak = 0;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void AllocationCounter::EndFrame()
+{
+    size_t count = GetCount();
+    s_lastFrameCount = count - s_frameStartCount;
+    s_frameStartCount = count;
+    s_zeroFrameStreak = s_lastFrameCount == 0 ? s_zeroFrameStreak + 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t AllocationCounter::GetLastFrameCount()
+{
+    return s_lastFrameCount;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t AllocationCounter::GetZeroFrameStreak()
+{
+    return s_zeroFrameStreak;
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+static std::atomic<size_t> s_allocationCount{0};
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+static void* CountedAlloc(size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if ( void* ptr = std::malloc(size ? size : 1) )
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+static void* CountedAlignedAlloc(size_t size, std::align_val_t alignment)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    size_t align = (size_t)alignment;
+    size = (size + align - 1) / align * align;
+    if ( void* ptr = std::aligned_alloc(align, size ? size : align) )
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size)                                         { return CountedAlloc(size); }
+void* operator new[](size_t size)                                       { return CountedAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept         { try { return CountedAlloc(size); } catch (...) { return nullptr; } }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept       { try { return CountedAlloc(size); } catch (...) { return nullptr; } }
+void* operator new(size_t size, std::align_val_t align)                 { return CountedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align)               { return CountedAlignedAlloc(size, align); }
+void operator delete(void* ptr) noexcept                                { std::free(ptr); }
+void operator delete[](void* ptr) noexcept                              { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept                        { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept                      { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept              { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept            { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept      { std::free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept    { std::free(ptr); }
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool AllocationCounter::IsEnabled()
+{
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t AllocationCounter::GetCount()
+{
+    return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void* AllocationCounter::Malloc(size_t size, void*)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void AllocationCounter::Free(void* ptr, void*)
+{
+    std::free(ptr);
+}
+
+#else
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool AllocationCounter::IsEnabled()
+{
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t AllocationCounter::GetCount()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef _allocators_h_
+#define _allocators_h_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Bump allocator over one fixed block. Individual allocations are never freed,
+// the whole arena is reset at once.
+// -----------------------------------------------------------------------------
+class LinearArena
+{
+public:
+
+    explicit LinearArena(size_t capacity);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    void Reset();
+
+    template <typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    T* NewArray(size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    inline size_t GetUsed() const
+    {
+        return _offset;
+    }
+
+    inline size_t GetCapacity() const
+    {
+        return _capacity;
+    }
+
+    inline size_t GetOverflowBytes() const
+    {
+        return _overflowBytes;
+    }
+
+private:
+
+    unsigned char*              _buffer   = nullptr;
+    size_t                      _capacity = 0;
+    size_t                      _offset   = 0;
+
+    // allocations that did not fit, released on Reset
+    std::vector<void*>          _overflow;
+    size_t                      _overflowBytes = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Two linear arenas used on alternate frames, memory handed out during frame N
+// stays valid until the start of frame N + 2.
+// -----------------------------------------------------------------------------
+class FrameArena
+{
+public:
+
+    static FrameArena& Get();
+
+    void BeginFrame();
+
+    inline LinearArena& GetCurrent()
+    {
+        return *_arenas[_current];
+    }
+
+    inline void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        return GetCurrent().Allocate(size, alignment);
+    }
+
+    inline size_t GetHighWaterMark() const
+    {
+        return _highWaterMark;
+    }
+
+private:
+
+    FrameArena();
+
+    static constexpr size_t     s_capacity = 4u * 1024u * 1024u;
+
+    std::unique_ptr<LinearArena> _arenas[2];
+    unsigned int                _current        = 0;
+    size_t                      _highWaterMark  = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Standard allocator on top of a linear arena, deallocate is a no-op.
+// -----------------------------------------------------------------------------
+template <typename T>
+class ArenaAllocator
+{
+public:
+
+    using value_type = T;
+
+    ArenaAllocator(LinearArena& arena = FrameArena::Get().GetCurrent())
+        : _arena(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : _arena(other.GetArena())
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(_arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t)
+    {
+    }
+
+    inline LinearArena* GetArena() const
+    {
+        return _arena;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return _arena == other.GetArena();
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const
+    {
+        return _arena != other.GetArena();
+    }
+
+private:
+
+    LinearArena*    _arena;
+};
+
+// vector whose storage comes from this frame's arena
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// -----------------------------------------------------------------------------
+// Fixed number of slots for objects of one type, the storage is allocated once
+// when the pool is created.
+// -----------------------------------------------------------------------------
+template <typename T>
+class ObjectPool
+{
+public:
+
+    explicit ObjectPool(size_t capacity)
+        : _storage(new Storage[capacity]),
+          _capacity(capacity)
+    {
+        _freeList.reserve(capacity);
+        for ( size_t ii = capacity; ii > 0; --ii )
+            _freeList.push_back(ii - 1);
+    }
+
+    ~ObjectPool()
+    {
+        assert(_freeList.size() == _capacity && "objects still alive in pool");
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* Create(Args&&... args)
+    {
+        if ( _freeList.empty() )
+            return nullptr;
+
+        size_t index = _freeList.back();
+        _freeList.pop_back();
+        return new (&_storage[index]) T(std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* object)
+    {
+        if ( !object )
+            return;
+
+        size_t index = reinterpret_cast<Storage*>(object) - _storage.get();
+        assert(index < _capacity);
+
+        object->~T();
+        _freeList.push_back(index);
+    }
+
+    inline size_t GetLiveCount() const
+    {
+        return _capacity - _freeList.size();
+    }
+
+private:
+
+    struct Storage
+    {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    std::unique_ptr<Storage[]>  _storage;
+    size_t                      _capacity = 0;
+    std::vector<size_t>         _freeList;
+};
+
+// -----------------------------------------------------------------------------
+// Non owning view of a contiguous range.
+// -----------------------------------------------------------------------------
+template <typename T>
+class ArrayView
+{
+public:
+
+    ArrayView(const T* data, size_t size)
+        : _data(data),
+          _size(size)
+    {
+    }
+
+    inline const T* begin() const
+    {
+        return _data;
+    }
+
+    inline const T* end() const
+    {
+        return _data + _size;
+    }
+
+    inline size_t size() const
+    {
+        return _size;
+    }
+
+    inline const T& operator[](size_t ii) const
+    {
+        return _data[ii];
+    }
+
+private:
+
+    const T*    _data = nullptr;
+    size_t      _size = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Heap allocation counting, only active when built with COUNT_ALLOCATIONS.
+// -----------------------------------------------------------------------------
+namespace AllocationCounter
+{
+    bool IsEnabled();
+    size_t GetCount();
+
+    // call once per frame, measures the allocations made since the last call
+    void EndFrame();
+    size_t GetLastFrameCount();
+    size_t GetZeroFrameStreak();
+
+#ifdef COUNT_ALLOCATIONS
+    // hooks for libraries that allocate through malloc style callbacks
+    void* Malloc(size_t size, void* userData);
+    void Free(void* ptr, void* userData);
+#endif
+}
+
+#endif // _allocators_h_
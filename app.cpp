@@ -1,13 +1,32 @@
 #include "renderer.h"
 
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <stb_image.h>
 #include "tests/testtexture2d.h"
 #include "tests/testclearcolor.h"
+#include "tests/testtexturestress.h"
+#include "tests/testtransformbench.h"
+#include "tests/testgpudriven.h"
+#include "tests/testvirtualtexture.h"
+#include "tests/testtextbench.h"
+#include "tests/teststaticbatch.h"
+#include "tests/testparticles.h"
+#include "tests/testoverdraw.h"
+#include "tests/testlights.h"
+#include "resourcememory.h"
+#include "textureresidency.h"
+#include "resourcemanager.h"
+#include "allocators.h"
+#include "overlaycompositor.h"
+#include "framepacer.h"
+#include "renderscaler.h"
+#include "glcapture.h"
 
 const char* glsl_version = "#version 130";
 
@@ -24,6 +43,10 @@ int main(void)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_DEPTH_BITS, 24);
+#ifdef GL_DEBUG_LAYER
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
 
     // Create a windowed mode window and its OpenGL context
     window = glfwCreateWindow(960, 540, "Hello World", nullptr, nullptr);
@@ -36,32 +59,60 @@ int main(void)
     // Make the window's context current
     glfwMakeContextCurrent(window);
 
-    glfwSwapInterval(1);
-
     if ( GLEW_OK == glewInit() )
         std::cout << glGetString(GL_VERSION) << std::endl;
     else
         return 0;
 
+    GLDebug::Install();
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     Renderer renderer;
 
+#ifdef COUNT_ALLOCATIONS
+    ImGui::SetAllocatorFunctions(AllocationCounter::Malloc, AllocationCounter::Free);
+#endif
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    std::unique_ptr<OverlayCompositor> overlay = std::make_unique<OverlayCompositor>();
+    std::unique_ptr<FramePacer> pacer = std::make_unique<FramePacer>(window);
+    std::unique_ptr<RenderScaler> scaler = std::make_unique<RenderScaler>();
+    float shownFramerate = 0.0f;
+    char capturePath[256] = "capture.gltrace";
+    int captureFrames = 300;
+    double lastFramerateSample = 0.0;
+
+    // every image loader flips; the flag is a plain global in stb_image, so it
+    // is set once before the scene preparer starts decoding on its workers
+    stbi_set_flip_vertically_on_load(1);
+
     test::Test* currentTest = nullptr;
     test::TestMenu *testMenu = new test::TestMenu(currentTest);
     currentTest = testMenu;
 
     testMenu->RegisterTest<test::TestClearColor>("Clear Color");
     testMenu->RegisterTest<test::TestTexture2D>("2D Texture");
+    testMenu->RegisterTest<test::TestTextureStress>("Texture Residency Stress");
+    testMenu->RegisterTest<test::TestTransformBench>("Transform Benchmark");
+    testMenu->RegisterTest<test::TestGpuDriven>("GPU Driven Rendering");
+    testMenu->RegisterTest<test::TestVirtualTexture>("Virtual Texture Streaming");
+    testMenu->RegisterTest<test::TestTextBench>("SDF Text Benchmark");
+    testMenu->RegisterTest<test::TestStaticBatch>("Static Batch Tile Map");
+    testMenu->RegisterTest<test::TestParticles>("GPU Particles");
+    testMenu->RegisterTest<test::TestOverdraw>("Overdraw Passes");
+    testMenu->RegisterTest<test::TestLights>("Tiled Lights");
 
     // Loop until the user closes the window
     while (!glfwWindowShouldClose(window))
     {
+        float deltaTime = pacer->BeginFrame();
+        FrameArena::Get().BeginFrame();
+        TextureResidency::Get().BeginFrame();
+
         // Render here
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         renderer.Clear();
@@ -70,19 +121,84 @@ int main(void)
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
+        testMenu->Update();
+
+        {
+            // sampled so the text does not change, and force an overlay redraw, every frame
+            if ( ImGui::GetTime() - lastFramerateSample >= 0.5 )
+            {
+                shownFramerate = ImGui::GetIO().Framerate;
+                lastFramerateSample = ImGui::GetTime();
+            }
+            ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / shownFramerate, shownFramerate);
+            if ( AllocationCounter::IsEnabled() )
+            {
+                ImGui::Text("Heap allocations last frame: %zu (zero for %zu frames)",
+                            AllocationCounter::GetLastFrameCount(), AllocationCounter::GetZeroFrameStreak());
+                ImGui::Text("Frame arena high water mark: %zu KB", FrameArena::Get().GetHighWaterMark() / 1024);
+            }
+        }
+
+        if ( ImGui::Begin("GPU Memory") )
+        {
+            ResourceMemory::OnImGuiRender();
+            ImGui::Separator();
+            ResourceManager::Get().OnImGuiRender();
+        }
+        ImGui::End();
+
+        if ( ImGui::Begin("Overlay") )
+            overlay->OnImGuiRender();
+        ImGui::End();
 
+        if ( ImGui::Begin("Frame Pacing") )
+            pacer->OnImGuiRender();
+        ImGui::End();
+
+        if ( ImGui::Begin("Render Scale") )
+            scaler->OnImGuiRender();
+        ImGui::End();
+
+        if ( ImGui::Begin("GL Debug") )
+            GLDebug::OnImGuiRender();
+        ImGui::End();
+
+        if ( ImGui::Begin("Capture") )
         {
-            ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+            if ( GLCapture::IsRecording() )
+            {
+                ImGui::Text("Recording frame %u of %d", GLCapture::GetRecordedFrames(), captureFrames);
+                if ( ImGui::Button("Stop") )
+                    GLCapture::End();
+            }
+            else
+            {
+                ImGui::InputText("Trace", capturePath, sizeof(capturePath));
+                ImGui::SliderInt("Frames", &captureFrames, 1, 3000);
+                if ( ImGui::Button("Record") )
+                {
+                    int width = 0, height = 0;
+                    glfwGetFramebufferSize(window, &width, &height);
+                    GLCapture::Begin(capturePath, (unsigned int)captureFrames, width, height);
+                }
+            }
         }
+        ImGui::End();
 
         if ( currentTest )
         {
-            currentTest->OnUpdate(0.0f);
+            int width = 0, height = 0;
+            glfwGetFramebufferSize(window, &width, &height);
+
+            // the scene may render below native resolution, the overlay never does
+            currentTest->OnUpdate(deltaTime);
+            scaler->BeginScene(width, height);
             currentTest->OnRender();
+            scaler->EndScene();
             ImGui::Begin("Test");
             if ( currentTest != testMenu && ImGui::Button("< ") )
             {
-                delete currentTest;
+                testMenu->DestroyTest(currentTest);
                 currentTest = testMenu;
             }
             currentTest->OnImGuiRender();
@@ -90,26 +206,42 @@ int main(void)
         }
 
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        overlay->Render(ImGui::GetDrawData());
 
         // Swap front and back buffers
-        glfwSwapBuffers(window);
+        pacer->Present();
 
         // Poll for and process events
         glfwPollEvents();
-    }
 
-    delete currentTest;
-    if ( testMenu != currentTest )
-    {
-        delete testMenu;
+        ResourceManager::Get().EndFrame();
+        AllocationCounter::EndFrame();
+        GLDebug::EndFrame();
+        GLCapture::EndFrame(deltaTime * 1000.0f);
     }
 
+    testMenu->DestroyTest(currentTest);
+    delete testMenu;
+
+    GLCapture::End();
+    ResourceManager::Get().Shutdown();
+    overlay.reset();
+    pacer.reset();
+    scaler.reset();
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
     glfwTerminate();
+
+    // lets a test run fail on GL errors
+    if ( GLDebug::GetErrorCount() > 0 )
+    {
+        std::cout << GLDebug::GetErrorCount() << " GL errors reported" << std::endl;
+        return 1;
+    }
+
     return 0;
 }
 
@@ -0,0 +1,113 @@
+#include "renderer.h"
+#include "framebuffer.h"
+#include "resourcememory.h"
+
+#include <iostream>
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Framebuffer::Framebuffer( int width, int height, bool depth )
+    : _hasDepth(depth),
+      _width(width),
+      _height(height)
+{
+    Create();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Framebuffer::~Framebuffer()
+{
+    Destroy();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Framebuffer::Create()
+{
+    glGenTextures(1, &_colorID);
+    glBindTexture(GL_TEXTURE_2D, _colorID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &_rendererID);
+    glBindFramebuffer(GL_FRAMEBUFFER, _rendererID);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _colorID, 0);
+
+    if ( _hasDepth )
+    {
+        glGenRenderbuffers(1, &_depthID);
+        glBindRenderbuffer(GL_RENDERBUFFER, _depthID);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, _width, _height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthID);
+    }
+
+    if ( glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE )
+        std::cout << "[Framebuffer] incomplete " << _width << "x" << _height << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    ResourceMemory::Allocate(ResourceMemory::Category::Texture, GetSizeInBytes());
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Framebuffer::Destroy()
+{
+    glDeleteFramebuffers(1, &_rendererID);
+    glDeleteTextures(1, &_colorID);
+    if ( _depthID )
+        glDeleteRenderbuffers(1, &_depthID);
+    _rendererID = _colorID = _depthID = 0;
+
+    ResourceMemory::Free(ResourceMemory::Category::Texture, GetSizeInBytes());
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t Framebuffer::GetSizeInBytes() const
+{
+    // color plus depth, both 4 bytes per pixel
+    return (size_t)_width * _height * (_hasDepth ? 8u : 4u);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Framebuffer::Resize(int width, int height)
+{
+    if ( width == _width && height == _height )
+        return;
+
+    Destroy();
+    _width = width;
+    _height = height;
+    Create();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Framebuffer::Bind() const
+{
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_previousID);
+    glBindFramebuffer(GL_FRAMEBUFFER, _rendererID);
+    glViewport(0, 0, _width, _height);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Framebuffer::Unbind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, (unsigned int)_previousID);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Framebuffer::BindTexture(unsigned int slot) const
+{
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_2D, _colorID);
+}
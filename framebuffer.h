@@ -0,0 +1,55 @@
+#ifndef _framebuffer_h_
+#define _framebuffer_h_
+
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Offscreen render target with a single RGBA8 color texture and an optional
+// 24 bit depth renderbuffer.
+// -----------------------------------------------------------------------------
+class Framebuffer
+{
+public:
+
+    Framebuffer( int width, int height, bool depth = false );
+    ~Framebuffer();
+
+    // reallocates the attachment, contents are undefined afterwards
+    void Resize(int width, int height);
+
+    void Bind() const;
+    // back to the framebuffer that was bound before Bind, so targets nest
+    void Unbind() const;
+    void BindTexture(unsigned int slot = 0) const;
+
+    inline int GetWidth() const
+    {
+        return _width;
+    }
+
+    inline int GetHeight() const
+    {
+        return _height;
+    }
+
+    inline unsigned int GetColorAttachment() const
+    {
+        return _colorID;
+    }
+
+private:
+
+    void Create();
+    void Destroy();
+    size_t GetSizeInBytes() const;
+
+    unsigned int    _rendererID = 0;
+    unsigned int    _colorID    = 0;
+    unsigned int    _depthID    = 0;
+    bool            _hasDepth   = false;
+    int             _width      = 0;
+    int             _height     = 0;
+    mutable int     _previousID = 0;
+};
+
+#endif // _framebuffer_h_
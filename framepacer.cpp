@@ -0,0 +1,251 @@
+#include "renderer.h"
+#include "framepacer.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+
+// below this the remaining wait is spun instead of slept, sleeps overshoot
+const std::chrono::microseconds s_spinThreshold(2000);
+
+const float s_frameBinMs    = 0.5f;
+const float s_latencyBinMs  = 1.0f;
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+FramePacer::FramePacer(GLFWwindow* window)
+    : _window(window),
+      _lastFrame(Clock::now()),
+      _nextPresent(_lastFrame)
+{
+    _adaptiveSupported = glfwExtensionSupported("GLX_EXT_swap_control_tear") ||
+                         glfwExtensionSupported("WGL_EXT_swap_control_tear");
+
+    glGenQueries(s_maxFrames, _queries);
+    SetMode(Mode::VSync);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+FramePacer::~FramePacer()
+{
+    while ( _count > 0 )
+        Retire(true);
+
+    glDeleteQueries(s_maxFrames, _queries);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const char* FramePacer::GetModeName(Mode mode)
+{
+    switch ( mode )
+    {
+        case Mode::VSync:       return "VSync";
+        case Mode::Uncapped:    return "Uncapped";
+        case Mode::FixedRate:   return "Fixed rate";
+        case Mode::Adaptive:    return "Adaptive vsync";
+        default:                return "?";
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void FramePacer::SetMode(Mode mode)
+{
+    _mode = mode;
+    _nextPresent = Clock::now();
+
+    switch ( mode )
+    {
+        case Mode::VSync:       glfwSwapInterval(1); break;
+        case Mode::Adaptive:    glfwSwapInterval(_adaptiveSupported ? -1 : 1); break;
+        default:                glfwSwapInterval(0); break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void FramePacer::SetMaxFramesInFlight(unsigned int frames)
+{
+    _maxFramesInFlight = std::clamp(frames, 1u, s_maxFrames);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool FramePacer::Retire(bool wait)
+{
+    InFlight& frame = _inFlight[_head];
+    GLenum status = glClientWaitSync(frame.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                     wait ? 1000000000ull : 0);
+    if ( status == GL_TIMEOUT_EXPIRED && !wait )
+        return false;
+
+    // the timestamp was written before the fence, so it is available once the
+    // fence signalled; after a timeout or a failed wait reading it could block
+    // forever, so the frame leaves the window without a latency sample
+    bool signalled = status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+    if ( signalled )
+    {
+        GLint64 gpuEnd = 0;
+        glGetQueryObjecti64v(_queries[_head], GL_QUERY_RESULT, &gpuEnd);
+        if ( frame.cpuStartGpuTime > 0 && gpuEnd > frame.cpuStartGpuTime )
+            _latencies[_latencySamples++ % s_history] = (float)((gpuEnd - frame.cpuStartGpuTime) * 1e-6);
+    }
+
+    glDeleteSync(frame.fence);
+    frame.fence = nullptr;
+    _head = (_head + 1) % s_maxFrames;
+    --_count;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+float FramePacer::BeginFrame()
+{
+    Clock::time_point now = Clock::now();
+    float deltaTime = std::chrono::duration<float>(now - _lastFrame).count();
+    _lastFrame = now;
+    _frameTimes[_frameSamples++ % s_history] = deltaTime * 1000.0f;
+
+    // collect whatever finished, then block until under the limit
+    while ( _count > 0 && Retire(false) )
+        ;
+
+    while ( _count >= _maxFramesInFlight )
+        Retire(true);
+
+    glGetInteger64v(GL_TIMESTAMP, &_cpuStartGpuTime);
+
+    // a long stall (breakpoint, window drag) should not teleport animations
+    return std::min(deltaTime, 0.25f);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void FramePacer::WaitUntil(Clock::time_point target)
+{
+    for ( ;; )
+    {
+        Clock::duration remaining = target - Clock::now();
+        if ( remaining <= Clock::duration::zero() )
+            return;
+
+        if ( remaining > s_spinThreshold )
+            std::this_thread::sleep_for(remaining - s_spinThreshold);
+        else
+            std::this_thread::yield();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void FramePacer::Present()
+{
+    unsigned int slot = (_head + _count) % s_maxFrames;
+    glQueryCounter(_queries[slot], GL_TIMESTAMP);
+
+    if ( _mode == Mode::FixedRate && _targetRate > 0.0 )
+    {
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / _targetRate));
+        Clock::time_point now = Clock::now();
+
+        // keep the cadence unless we fell more than a frame behind
+        _nextPresent += period;
+        if ( _nextPresent < now - period )
+            _nextPresent = now;
+
+        WaitUntil(_nextPresent);
+    }
+
+    glfwSwapBuffers(_window);
+
+    _inFlight[slot] = { glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), _cpuStartGpuTime };
+    ++_count;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void FramePacer::UpdateHistograms()
+{
+    std::fill(std::begin(_frameBins), std::end(_frameBins), 0.0f);
+    std::fill(std::begin(_latencyBins), std::end(_latencyBins), 0.0f);
+
+    unsigned int frames = std::min(_frameSamples, s_history);
+    double sum = 0.0, sumSquares = 0.0;
+    for ( unsigned int ii = 0; ii < frames; ++ii )
+    {
+        float ms = _frameTimes[ii];
+        sum += ms;
+        sumSquares += (double)ms * ms;
+        _frameBins[std::min((unsigned int)(ms / s_frameBinMs), s_bins - 1)] += 1.0f;
+    }
+
+    if ( frames )
+    {
+        double mean = sum / frames;
+        _meanFrameMs = (float)mean;
+        _jitterMs = (float)std::sqrt(std::max(0.0, sumSquares / frames - mean * mean));
+    }
+
+    unsigned int latencies = std::min(_latencySamples, s_history);
+    sum = 0.0;
+    for ( unsigned int ii = 0; ii < latencies; ++ii )
+    {
+        sum += _latencies[ii];
+        _latencyBins[std::min((unsigned int)(_latencies[ii] / s_latencyBinMs), s_bins - 1)] += 1.0f;
+    }
+
+    if ( latencies )
+        _meanLatencyMs = (float)(sum / latencies);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void FramePacer::OnImGuiRender()
+{
+    const char* names[(int)Mode::Count];
+    for ( int mm = 0; mm < (int)Mode::Count; ++mm )
+        names[mm] = GetModeName((Mode)mm);
+
+    int mode = (int)_mode;
+    if ( ImGui::Combo("Present mode", &mode, names, (int)Mode::Count) )
+        SetMode((Mode)mode);
+
+    if ( _mode == Mode::Adaptive && !_adaptiveSupported )
+        ImGui::TextDisabled("swap_control_tear not available, using vsync");
+
+    if ( _mode == Mode::FixedRate )
+    {
+        float rate = (float)_targetRate;
+        if ( ImGui::SliderFloat("Target rate (Hz)", &rate, 10.0f, 360.0f, "%.0f") )
+            SetTargetRate(rate);
+    }
+
+    int inFlight = (int)_maxFramesInFlight;
+    if ( ImGui::SliderInt("Max frames in flight", &inFlight, 1, (int)s_maxFrames) )
+        SetMaxFramesInFlight((unsigned int)inFlight);
+
+    // refresh twice a second so the overlay is not redrawn every frame
+    if ( ImGui::GetTime() - _lastHistogram >= 0.5 )
+    {
+        UpdateHistograms();
+        _lastHistogram = ImGui::GetTime();
+    }
+
+    ImGui::Text("Frame time %.2f ms, jitter (std dev) %.2f ms", _meanFrameMs, _jitterMs);
+    ImGui::PlotHistogram("##frametime", _frameBins, s_bins, 0, "frame time, 0.5 ms bins", 0.0f, FLT_MAX,
+                         ImVec2(0.0f, 60.0f));
+    ImGui::Text("CPU start to GPU done %.2f ms", _meanLatencyMs);
+    ImGui::PlotHistogram("##latency", _latencyBins, s_bins, 0, "latency, 1 ms bins", 0.0f, FLT_MAX,
+                         ImVec2(0.0f, 60.0f));
+}
@@ -0,0 +1,111 @@
+#ifndef _framepacer_h_
+#define _framepacer_h_
+
+#include <chrono>
+#include <cstdint>
+
+struct GLFWwindow;
+typedef struct __GLsync* GLsync;
+
+// -----------------------------------------------------------------------------
+// Owns the present step of the main loop. Picks the swap interval for the
+// selected mode, paces fixed rate frames with a coarse sleep followed by a
+// short spin, and uses fences to keep the CPU at most a given number of frames
+// ahead of the GPU. Frame time jitter and the latency from the start of a
+// frame on the CPU to its completion on the GPU are kept for display.
+// -----------------------------------------------------------------------------
+class FramePacer
+{
+public:
+
+    enum class Mode
+    {
+        VSync,
+        Uncapped,
+        FixedRate,
+        Adaptive,
+        Count
+    };
+
+    explicit FramePacer(GLFWwindow* window);
+    ~FramePacer();
+
+    // waits for the frames in flight limit, returns seconds since last frame
+    float BeginFrame();
+    // fixed rate wait, swap and fence
+    void Present();
+
+    void SetMode(Mode mode);
+    inline Mode GetMode() const
+    {
+        return _mode;
+    }
+
+    inline void SetTargetRate(double hz)
+    {
+        _targetRate = hz;
+    }
+
+    void SetMaxFramesInFlight(unsigned int frames);
+    inline unsigned int GetMaxFramesInFlight() const
+    {
+        return _maxFramesInFlight;
+    }
+
+    inline bool IsAdaptiveSupported() const
+    {
+        return _adaptiveSupported;
+    }
+
+    static const char* GetModeName(Mode mode);
+
+    void OnImGuiRender();
+
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    void WaitUntil(Clock::time_point target);
+    bool Retire(bool wait);
+    void UpdateHistograms();
+
+    static constexpr unsigned int s_maxFrames   = 4;
+    static constexpr unsigned int s_history     = 240;
+    static constexpr unsigned int s_bins        = 60;
+
+    GLFWwindow*         _window             = nullptr;
+    Mode                _mode               = Mode::VSync;
+    double              _targetRate         = 60.0;
+    unsigned int        _maxFramesInFlight  = 2;
+    bool                _adaptiveSupported  = false;
+
+    Clock::time_point   _lastFrame;
+    Clock::time_point   _nextPresent;
+
+    // fences and timestamp queries of the frames not yet known to be done
+    struct InFlight
+    {
+        GLsync          fence;
+        int64_t         cpuStartGpuTime;
+    };
+    InFlight            _inFlight[s_maxFrames]  = {};
+    unsigned int        _queries[s_maxFrames]   = {};
+    unsigned int        _head                   = 0;
+    unsigned int        _count                  = 0;
+    int64_t             _cpuStartGpuTime        = 0;
+
+    float               _frameTimes[s_history]  = {};
+    float               _latencies[s_history]   = {};
+    unsigned int        _frameSamples           = 0;
+    unsigned int        _latencySamples         = 0;
+
+    // refreshed twice a second for display
+    float               _frameBins[s_bins]      = {};
+    float               _latencyBins[s_bins]    = {};
+    float               _meanFrameMs            = 0.0f;
+    float               _jitterMs               = 0.0f;
+    float               _meanLatencyMs          = 0.0f;
+    double              _lastHistogram          = 0.0;
+};
+
+#endif // _framepacer_h_
@@ -0,0 +1,407 @@
+#include "renderer.h"
+#include "glcapture.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+
+struct Recording
+{
+    std::ofstream                   file;
+    TraceHeader                     header;
+    unsigned int                    frameLimit  = 0;
+    bool                            active      = false;    // begins with the next frame
+    bool                            pending     = false;
+
+    // command bytes of the current frame, written out at EndFrame
+    std::vector<uint8_t>            frame;
+
+    // objects already written in this recording
+    std::unordered_set<unsigned int> buffers;
+    std::unordered_set<unsigned int> textures;
+    std::unordered_set<unsigned int> programs;
+    std::unordered_set<unsigned int> vertexArrays;
+    std::unordered_set<uint64_t>    uniforms;               // program << 32 | location
+
+    TraceRenderState                state       = {};
+    bool                            stateValid  = false;
+};
+
+Recording s_recording;
+
+// -----------------------------------------------------------------------------
+// Appends one command, payload pieces are given as pointer and size pairs.
+// -----------------------------------------------------------------------------
+struct Payload
+{
+    const void* data;
+    size_t      size;
+};
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Write(TraceOp op, std::initializer_list<Payload> pieces)
+{
+    TraceCommand command = { (uint16_t)op, 0, 0 };
+    for ( const Payload& piece : pieces )
+        command.size += (uint32_t)piece.size;
+
+    std::vector<uint8_t>& frame = s_recording.frame;
+    const uint8_t* bytes = (const uint8_t*)&command;
+    frame.insert(frame.end(), bytes, bytes + sizeof(command));
+    for ( const Payload& piece : pieces )
+    {
+        bytes = (const uint8_t*)piece.data;
+        frame.insert(frame.end(), bytes, bytes + piece.size);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+template <typename T>
+Payload Value(const T& value)
+{
+    return { &value, sizeof(T) };
+}
+
+// -----------------------------------------------------------------------------
+// Writes the buffer bound to target the first time it is seen.
+// -----------------------------------------------------------------------------
+void CaptureBuffer(unsigned int target, unsigned int id)
+{
+    if ( !s_recording.buffers.insert(id).second )
+        return;
+
+    GLint size = 0, usage = 0;
+    glGetBufferParameteriv(target, GL_BUFFER_SIZE, &size);
+    glGetBufferParameteriv(target, GL_BUFFER_USAGE, &usage);
+
+    std::vector<uint8_t> contents((size_t)size);
+    if ( size > 0 )
+        glGetBufferSubData(target, 0, size, contents.data());
+
+    uint32_t bytes = (uint32_t)size, usage32 = (uint32_t)usage;
+    Write(TraceOp::CreateBuffer, { Value(id), Value(usage32), Value(bytes), { contents.data(), contents.size() } });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void CaptureTexture(unsigned int id)
+{
+    if ( !s_recording.textures.insert(id).second )
+        return;
+
+    GLint params[6] = {};
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &params[0]);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &params[1]);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &params[2]);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &params[3]);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &params[4]);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &params[5]);
+
+    std::vector<uint8_t> pixels((size_t)params[0] * (size_t)params[1] * 4u);
+    if ( !pixels.empty() )
+    {
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
+
+    Write(TraceOp::CreateTexture, { Value(id), { params, sizeof(params) }, { pixels.data(), pixels.size() } });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void CaptureState()
+{
+    TraceRenderState state = {};
+    GLint value = 0;
+
+    glGetIntegerv(GL_VIEWPORT, state.viewport);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &value);    state.blendSrcRGB = (uint32_t)value;
+    glGetIntegerv(GL_BLEND_DST_RGB, &value);    state.blendDstRGB = (uint32_t)value;
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &value);  state.blendSrcAlpha = (uint32_t)value;
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &value);  state.blendDstAlpha = (uint32_t)value;
+    glGetIntegerv(GL_DEPTH_FUNC, &value);       state.depthFunc = (uint32_t)value;
+    glGetIntegerv(GL_DEPTH_WRITEMASK, &value);  state.depthMask = (uint8_t)value;
+    state.blend = glIsEnabled(GL_BLEND);
+    state.depthTest = glIsEnabled(GL_DEPTH_TEST);
+    state.cullFace = glIsEnabled(GL_CULL_FACE);
+
+    if ( s_recording.stateValid && std::memcmp(&state, &s_recording.state, sizeof(state)) == 0 )
+        return;
+
+    s_recording.state = state;
+    s_recording.stateValid = true;
+    Write(TraceOp::State, { Value(state) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool IsCapturing()
+{
+    return s_recording.active;
+}
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool GLCapture::Begin(const std::string& path, unsigned int frameCount, int width, int height)
+{
+    if ( s_recording.active || s_recording.pending )
+        return false;
+
+    s_recording.file.open(path, std::ios::binary | std::ios::trunc);
+    if ( !s_recording.file )
+    {
+        std::cout << "[GLCapture] cannot write " << path << std::endl;
+        return false;
+    }
+
+    s_recording.header = TraceHeader();
+    s_recording.header.width = width;
+    s_recording.header.height = height;
+    s_recording.file.write((const char*)&s_recording.header, sizeof(TraceHeader));
+
+    s_recording.frameLimit = frameCount;
+    s_recording.pending = true;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::End()
+{
+    if ( !s_recording.active && !s_recording.pending )
+        return;
+
+    // the frame count is only known now
+    s_recording.file.seekp(0);
+    s_recording.file.write((const char*)&s_recording.header, sizeof(TraceHeader));
+    s_recording.file.close();
+
+    std::cout << "[GLCapture] recorded " << s_recording.header.frameCount << " frames" << std::endl;
+
+    s_recording.active = s_recording.pending = s_recording.stateValid = false;
+    s_recording.frame.clear();
+    s_recording.buffers.clear();
+    s_recording.textures.clear();
+    s_recording.programs.clear();
+    s_recording.vertexArrays.clear();
+    s_recording.uniforms.clear();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool GLCapture::IsRecording()
+{
+    return s_recording.active || s_recording.pending;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+unsigned int GLCapture::GetRecordedFrames()
+{
+    return s_recording.header.frameCount;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::EndFrame(float frameMs)
+{
+    if ( s_recording.pending )
+    {
+        s_recording.pending = false;
+        s_recording.active = true;
+        return;
+    }
+
+    if ( !s_recording.active )
+        return;
+
+    Write(TraceOp::EndFrame, { Value(frameMs) });
+    s_recording.file.write((const char*)s_recording.frame.data(), (std::streamsize)s_recording.frame.size());
+    s_recording.frame.clear();
+
+    if ( ++s_recording.header.frameCount >= s_recording.frameLimit )
+        End();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::BindBuffer(unsigned int target, unsigned int id)
+{
+    if ( !IsCapturing() )
+        return;
+
+    CaptureBuffer(target, id);
+    Write(TraceOp::BindBuffer, { Value(target), Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::BufferData(unsigned int target, unsigned int size, unsigned int usage)
+{
+    if ( !IsCapturing() )
+        return;
+
+    Write(TraceOp::BufferData, { Value(target), Value(size), Value(usage) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::BufferSubData(unsigned int target, unsigned int offset, unsigned int size, const void* data)
+{
+    if ( !IsCapturing() )
+        return;
+
+    Write(TraceOp::BufferSubData, { Value(target), Value(offset), Value(size), { data, size } });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::DeleteBuffer(unsigned int id)
+{
+    // GL reuses names, a new object with this id must be written again
+    if ( IsCapturing() && s_recording.buffers.erase(id) )
+        Write(TraceOp::DeleteBuffer, { Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::BindTexture(unsigned int slot, unsigned int id)
+{
+    if ( !IsCapturing() )
+        return;
+
+    if ( id )
+        CaptureTexture(id);
+    Write(TraceOp::BindTexture, { Value(slot), Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::DeleteTexture(unsigned int id)
+{
+    if ( IsCapturing() && s_recording.textures.erase(id) )
+        Write(TraceOp::DeleteTexture, { Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::UseProgram(unsigned int id, const std::string& filePath)
+{
+    if ( !IsCapturing() )
+        return;
+
+    if ( s_recording.programs.insert(id).second )
+    {
+        // the source file, so replay compiles it for its own driver
+        std::ifstream stream(filePath, std::ios::binary);
+        std::string source((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+        uint32_t nameLength = (uint32_t)filePath.size(), sourceLength = (uint32_t)source.size();
+        Write(TraceOp::CreateProgram, { Value(id), Value(nameLength), { filePath.data(), filePath.size() },
+                                        Value(sourceLength), { source.data(), source.size() } });
+    }
+
+    Write(TraceOp::UseProgram, { Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::Uniform(unsigned int program, int location, const char* name, TraceUniform type,
+                        unsigned int count, const void* values)
+{
+    if ( !IsCapturing() || location < 0 )
+        return;
+
+    // locations can differ between drivers, replay looks them up by name
+    if ( s_recording.uniforms.insert((uint64_t)program << 32 | (uint32_t)location).second )
+    {
+        uint32_t nameLength = (uint32_t)std::strlen(name);
+        Write(TraceOp::UniformLocation, { Value(program), Value(location), Value(nameLength), { name, nameLength } });
+    }
+
+    uint8_t type8 = (uint8_t)type;
+    size_t size = (size_t)count * GetTraceUniformComponents(type) * 4u;
+    Write(TraceOp::Uniform, { Value(program), Value(location), Value(type8), Value(count), { values, size } });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::DeleteProgram(unsigned int id)
+{
+    if ( !IsCapturing() || !s_recording.programs.erase(id) )
+        return;
+
+    for ( auto it = s_recording.uniforms.begin(); it != s_recording.uniforms.end(); )
+        it = (*it >> 32) == id ? s_recording.uniforms.erase(it) : std::next(it);
+    Write(TraceOp::DeleteProgram, { Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::BindVertexArray(unsigned int id, const TraceVertexAttribute* attributes, unsigned int count)
+{
+    if ( !IsCapturing() )
+        return;
+
+    if ( s_recording.vertexArrays.insert(id).second )
+    {
+        // the buffers the attributes read from go first
+        GLint bound = 0;
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &bound);
+        for ( unsigned int ii = 0; ii < count; ++ii )
+        {
+            if ( s_recording.buffers.count(attributes[ii].buffer) )
+                continue;
+            glBindBuffer(GL_ARRAY_BUFFER, attributes[ii].buffer);
+            CaptureBuffer(GL_ARRAY_BUFFER, attributes[ii].buffer);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, (GLuint)bound);
+
+        Write(TraceOp::CreateVertexArray, { Value(id), Value(count),
+                                            { attributes, count * sizeof(TraceVertexAttribute) } });
+    }
+
+    Write(TraceOp::BindVertexArray, { Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::DeleteVertexArray(unsigned int id)
+{
+    if ( IsCapturing() && s_recording.vertexArrays.erase(id) )
+        Write(TraceOp::DeleteVertexArray, { Value(id) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::DrawElements(unsigned int mode, unsigned int count)
+{
+    if ( !IsCapturing() )
+        return;
+
+    CaptureState();
+    Write(TraceOp::DrawElements, { Value(mode), Value(count) });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLCapture::Clear(unsigned int mask)
+{
+    if ( !IsCapturing() )
+        return;
+
+    float color[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, color);
+    CaptureState();
+    Write(TraceOp::Clear, { Value(mask), { color, sizeof(color) } });
+}
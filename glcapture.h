@@ -0,0 +1,48 @@
+#ifndef _glcapture_h_
+#define _glcapture_h_
+
+#include "gltrace.h"
+
+#include <string>
+
+// -----------------------------------------------------------------------------
+// Records the GL calls made through Renderer, Shader, Texture, VertexArray,
+// VertexBuffer and IndexBuffer into a trace for the replay tool. Objects are
+// written the first time a recording uses them, with their contents read back
+// from GL, so a recording can start at any frame. Calls made directly to GL
+// elsewhere are not recorded. Everything here is a no-op unless recording.
+// -----------------------------------------------------------------------------
+namespace GLCapture
+{
+    // starts with the next frame and stops by itself after frameCount frames
+    bool Begin(const std::string& path, unsigned int frameCount, int width, int height);
+    void End();
+
+    bool IsRecording();
+    unsigned int GetRecordedFrames();
+
+    // call once per frame after presenting
+    void EndFrame(float frameMs);
+
+    // the wrappers call these after making the GL call
+    void BindBuffer(unsigned int target, unsigned int id);
+    void BufferData(unsigned int target, unsigned int size, unsigned int usage);
+    void BufferSubData(unsigned int target, unsigned int offset, unsigned int size, const void* data);
+    void DeleteBuffer(unsigned int id);
+
+    void BindTexture(unsigned int slot, unsigned int id);
+    void DeleteTexture(unsigned int id);
+
+    void UseProgram(unsigned int id, const std::string& filePath);
+    void Uniform(unsigned int program, int location, const char* name, TraceUniform type,
+                 unsigned int count, const void* values);
+    void DeleteProgram(unsigned int id);
+
+    void BindVertexArray(unsigned int id, const TraceVertexAttribute* attributes, unsigned int count);
+    void DeleteVertexArray(unsigned int id);
+
+    void DrawElements(unsigned int mode, unsigned int count);
+    void Clear(unsigned int mask);
+}
+
+#endif // _glcapture_h_
@@ -0,0 +1,257 @@
+#include "renderer.h"
+#include "gldebug.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__GLIBC__)
+    #include <execinfo.h>
+    #include <unistd.h>
+#endif
+
+#ifdef GL_DEBUG_LAYER
+
+static GLDebug::CallSite*       s_callSites = nullptr;
+static std::atomic<size_t>      s_errorCount{0};
+static bool                     s_installed = false;
+static unsigned int             s_lastFrameCalls = 0;
+
+// sites counted through GLCallFrom, keyed by call text and caller location
+struct CallerKey
+{
+    const char*     call;
+    const char*     file;
+    int             line;
+
+    bool operator==(const CallerKey& other) const
+    {
+        return call == other.call && file == other.file && line == other.line;
+    }
+};
+
+struct CallerKeyHash
+{
+    size_t operator()(const CallerKey& key) const
+    {
+        size_t hash = std::hash<const void*>()(key.call);
+        hash = hash * 31 + std::hash<const void*>()(key.file);
+        return hash * 31 + (size_t)key.line;
+    }
+};
+
+static std::unordered_map<CallerKey, std::unique_ptr<GLDebug::CallSite>, CallerKeyHash> s_callerSites;
+
+// refreshed twice a second so the overlay is not redrawn every frame
+static std::vector<const GLDebug::CallSite*> s_shownSites;
+static unsigned int             s_shownCalls = 0;
+static double                   s_lastSampleTime = 0.0;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+GLDebug::CallSite::CallSite( const char* call, const char* file, int line )
+    : call(call),
+      file(file),
+      line(line),
+      next(s_callSites)
+{
+    // only constructed on the GL thread, no locking needed
+    s_callSites = this;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+static const char* GetTypeName(GLenum type)
+{
+    switch ( type )
+    {
+        case GL_DEBUG_TYPE_ERROR:               return "Error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "Undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY:         return "Portability";
+        case GL_DEBUG_TYPE_PERFORMANCE:         return "Performance";
+        default:                                return "Other";
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+static void PrintStack()
+{
+#if defined(__GLIBC__)
+    void* frames[32];
+    int count = backtrace(frames, 32);
+    backtrace_symbols_fd(frames, count, STDERR_FILENO);
+#elif defined(_WIN32)
+    __debugbreak();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+static void GLAPIENTRY OnDebugMessage(GLenum, GLenum type, GLuint id, GLenum, GLsizei, const GLchar* message,
+                                      const void*)
+{
+    if ( type == GL_DEBUG_TYPE_ERROR )
+        s_errorCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::cerr << "[OpenGL " << GetTypeName(type) << "] (" << id << ") " << message << "\n";
+
+#ifndef NDEBUG
+    // synchronous output, the offending call is on this stack
+    if ( type == GL_DEBUG_TYPE_ERROR )
+        PrintStack();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLDebug::Count( const char* call, const Caller& caller )
+{
+    // only allocates the first time a site is seen
+    std::unique_ptr<CallSite>& site = s_callerSites[{ call, caller.file, caller.line }];
+    if ( !site )
+        site = std::make_unique<CallSite>(call, caller.file, caller.line);
+    ++site->count;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool GLDebug::IsEnabled()
+{
+    return s_installed;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool GLDebug::Install()
+{
+    if ( !GLEW_VERSION_4_3 && !GLEW_KHR_debug )
+    {
+        std::cout << "[GLDebug] KHR_debug not available, GL errors are not reported" << std::endl;
+        return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+#ifdef NDEBUG
+    glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+#else
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+#endif
+    glDebugMessageCallback(OnDebugMessage, nullptr);
+
+    // notifications are informational and some drivers send one per buffer
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+
+    s_installed = true;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLDebug::EndFrame()
+{
+    s_lastFrameCalls = 0;
+    for ( CallSite* site = s_callSites; site; site = site->next )
+    {
+        site->lastFrameCount = site->count;
+        site->count = 0;
+        s_lastFrameCalls += site->lastFrameCount;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t GLDebug::GetErrorCount()
+{
+    return s_errorCount.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLDebug::OnImGuiRender()
+{
+    const size_t shownCount = 16;
+
+    if ( ImGui::GetTime() - s_lastSampleTime >= 0.5 )
+    {
+        s_shownSites.clear();
+        for ( const CallSite* site = s_callSites; site; site = site->next )
+        {
+            if ( site->lastFrameCount )
+                s_shownSites.push_back(site);
+        }
+
+        size_t keep = std::min(shownCount, s_shownSites.size());
+        std::partial_sort(s_shownSites.begin(), s_shownSites.begin() + keep, s_shownSites.end(),
+                          [](const CallSite* a, const CallSite* b) { return a->lastFrameCount > b->lastFrameCount; });
+        s_shownSites.resize(keep);
+        s_shownCalls = s_lastFrameCalls;
+        s_lastSampleTime = ImGui::GetTime();
+    }
+
+    ImGui::Text("KHR_debug: %s", s_installed ? "installed" : "not available");
+    ImGui::Text("Errors reported: %zu", GetErrorCount());
+    ImGui::Text("Checked calls last frame: %u", s_shownCalls);
+
+    ImGui::Separator();
+    ImGui::Columns(2, "callsites");
+    ImGui::SetColumnWidth(0, 80.0f);
+    ImGui::Text("Per frame");   ImGui::NextColumn();
+    ImGui::Text("Call site");   ImGui::NextColumn();
+    ImGui::Separator();
+    for ( const CallSite* site : s_shownSites )
+    {
+        const char* file = std::strrchr(site->file, '/');
+        ImGui::Text("%u", site->lastFrameCount);    ImGui::NextColumn();
+        ImGui::Text("%s:%d", file ? file + 1 : site->file, site->line);
+        if ( ImGui::IsItemHovered() )
+            ImGui::SetTooltip("%s", site->call);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+#else
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool GLDebug::IsEnabled()
+{
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool GLDebug::Install()
+{
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLDebug::EndFrame()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t GLDebug::GetErrorCount()
+{
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GLDebug::OnImGuiRender()
+{
+    ImGui::TextDisabled("Built without GL_DEBUG_LAYER");
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef _gldebug_h_
+#define _gldebug_h_
+
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// GL error reporting through KHR_debug, only active when built with
+// GL_DEBUG_LAYER. The driver calls back on errors instead of every call
+// polling glGetError: synchronously with a stack trace in debug builds,
+// asynchronously in release builds. Without GL_DEBUG_LAYER GLCall(x) is just
+// x and nothing is checked or counted.
+//
+// Calls are counted per call site. The wrapper classes (Shader, Renderer,
+// the buffers) take a Caller defaulted at the call site and count with
+// GLCallFrom, so a uniform set or a draw is charged to the code that asked
+// for it rather than to the wrapper.
+// -----------------------------------------------------------------------------
+namespace GLDebug
+{
+    // one per call site, registered the first time it runs
+    struct CallSite
+    {
+        CallSite( const char* call, const char* file, int line );
+
+        const char*     call;
+        const char*     file;
+        int             line;
+        unsigned int    count           = 0;
+        unsigned int    lastFrameCount  = 0;
+        CallSite*       next            = nullptr;
+    };
+
+    // source location of a wrapper's caller, filled in by the default
+    // argument; empty and free to pass around without GL_DEBUG_LAYER
+    struct Caller
+    {
+#ifdef GL_DEBUG_LAYER
+        Caller( const char* file = __builtin_FILE(), int line = __builtin_LINE() )
+            : file(file),
+              line(line)
+        {
+        }
+
+        const char*     file;
+        int             line;
+#endif
+    };
+
+#ifdef GL_DEBUG_LAYER
+    // counts a call made by a wrapper on behalf of caller
+    void Count( const char* call, const Caller& caller );
+#endif
+
+    bool IsEnabled();
+
+    // call once the context is current, false if KHR_debug is missing
+    bool Install();
+
+    // call once per frame, measures the calls made since the last call
+    void EndFrame();
+    size_t GetErrorCount();
+
+    void OnImGuiRender();
+}
+
+#ifdef GL_DEBUG_LAYER
+    #define GLCall(x) do { static GLDebug::CallSite s_callSite(#x, __FILE__, __LINE__); \
+                           ++s_callSite.count; \
+                           x; } while (0)
+    #define GLCallFrom(caller, x) do { GLDebug::Count(#x, caller); \
+                                       x; } while (0)
+#else
+    #define GLCall(x) x
+    #define GLCallFrom(caller, x) (void)(caller), x
+#endif
+
+#endif // _gldebug_h_
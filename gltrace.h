@@ -0,0 +1,115 @@
+#ifndef _gltrace_h_
+#define _gltrace_h_
+
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// Layout of a GL trace written by GLCapture and read by the replay tool. The
+// header is followed by commands, each a TraceCommand and size bytes of
+// payload, frames end with TraceOp::EndFrame. Object ids are the GL names of
+// the recording context, replay maps them to its own.
+// -----------------------------------------------------------------------------
+struct TraceHeader
+{
+    static constexpr uint32_t Magic   = 0x52544C47; // "GLTR"
+    static constexpr uint32_t Version = 1;
+
+    uint32_t    magic       = Magic;
+    uint32_t    version     = Version;
+    int32_t     width       = 0;        // framebuffer size when recorded
+    int32_t     height      = 0;
+    uint32_t    frameCount  = 0;        // written when the recording ends
+    uint32_t    reserved    = 0;
+};
+
+struct TraceCommand
+{
+    uint16_t    op;
+    uint16_t    reserved;
+    uint32_t    size;
+};
+
+// payloads, all integers are 32 bit unless noted
+enum class TraceOp : uint16_t
+{
+    CreateBuffer,       // id, usage, size, bytes
+    BindBuffer,         // target, id
+    BufferData,         // target, size, usage; no data, orphans the storage
+    BufferSubData,      // target, offset, size, bytes
+    DeleteBuffer,       // id
+    CreateTexture,      // id, width, height, min, mag, wrapS, wrapT, RGBA8 bytes
+    BindTexture,        // slot, id
+    DeleteTexture,      // id
+    CreateProgram,      // id, name length, name, source length, .shader source
+    UseProgram,         // id
+    DeleteProgram,      // id
+    UniformLocation,    // program, location, name length, name
+    Uniform,            // program, location, TraceUniform (8 bit), count, values
+    CreateVertexArray,  // id, attribute count, TraceVertexAttribute[]
+    BindVertexArray,    // id
+    DeleteVertexArray,  // id
+    DrawElements,       // mode, count
+    Clear,              // mask, clear color[4]
+    State,              // TraceRenderState
+    EndFrame            // recorded frame time in ms as float
+};
+
+enum class TraceUniform : uint8_t
+{
+    Int,
+    UInt,
+    Float,
+    Vec2,
+    Vec4,
+    Mat4
+};
+
+// -----------------------------------------------------------------------------
+// Components of one element of a uniform type, all 4 bytes wide.
+// -----------------------------------------------------------------------------
+inline unsigned int GetTraceUniformComponents(TraceUniform type)
+{
+    switch ( type )
+    {
+        case TraceUniform::Vec2:    return 2;
+        case TraceUniform::Vec4:    return 4;
+        case TraceUniform::Mat4:    return 16;
+        default:                    return 1;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// One attribute as set up by VertexArray::AddBuffer.
+// -----------------------------------------------------------------------------
+struct TraceVertexAttribute
+{
+    uint32_t    buffer;
+    uint32_t    index;
+    int32_t     count;
+    uint32_t    type;
+    uint32_t    stride;
+    uint32_t    offset;
+    uint32_t    divisor;
+    uint8_t     normalized;
+    uint8_t     integer;        // set with glVertexAttribIPointer
+    uint8_t     pad[2];
+};
+
+// -----------------------------------------------------------------------------
+// Fixed function state read back before a draw, recorded when it changes.
+// -----------------------------------------------------------------------------
+struct TraceRenderState
+{
+    int32_t     viewport[4];
+    uint32_t    blendSrcRGB;
+    uint32_t    blendDstRGB;
+    uint32_t    blendSrcAlpha;
+    uint32_t    blendDstAlpha;
+    uint32_t    depthFunc;
+    uint8_t     blend;
+    uint8_t     depthTest;
+    uint8_t     depthMask;
+    uint8_t     cullFace;
+};
+
+#endif // _gltrace_h_
@@ -0,0 +1,70 @@
+#include "renderer.h"
+#include "gpubuffer.h"
+#include "resourcememory.h"
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+GpuBuffer::GpuBuffer( unsigned int target, const void* data, unsigned int size, unsigned int usage )
+    : _target(target),
+      _size(size),
+      _usage(usage)
+{
+    glGenBuffers(1, &_rendererID);
+    glBindBuffer(_target, _rendererID);
+    glBufferData(_target, size, data, usage);
+
+    ResourceMemory::Allocate(ResourceMemory::Category::StorageBuffer, _size);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+GpuBuffer::~GpuBuffer()
+{
+    glDeleteBuffers(1, &_rendererID);
+
+    ResourceMemory::Free(ResourceMemory::Category::StorageBuffer, _size);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GpuBuffer::Bind() const
+{
+    glBindBuffer(_target, _rendererID);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GpuBuffer::Unbind() const
+{
+    glBindBuffer(_target, 0);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GpuBuffer::BindBase(unsigned int index) const
+{
+    glBindBufferBase(_target, index, _rendererID);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GpuBuffer::BindBase(unsigned int target, unsigned int index) const
+{
+    glBindBufferBase(target, index, _rendererID);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GpuBuffer::SetSubData(unsigned int offset, unsigned int size, const void* data)
+{
+    glBindBuffer(_target, _rendererID);
+    glBufferSubData(_target, offset, size, data);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void GpuBuffer::Orphan()
+{
+    glBindBuffer(_target, _rendererID);
+    glBufferData(_target, _size, nullptr, _usage);
+}
@@ -0,0 +1,46 @@
+#ifndef _gpubuffer_h_
+#define _gpubuffer_h_
+
+// -----------------------------------------------------------------------------
+// Generic GL buffer for storage, indirect and uniform data that can be
+// rewritten in place.
+// -----------------------------------------------------------------------------
+class GpuBuffer
+{
+public:
+
+    GpuBuffer( unsigned int target, const void* data, unsigned int size, unsigned int usage );
+    ~GpuBuffer();
+
+    void Bind() const;
+    void Unbind() const;
+
+    // binds to an indexed binding point of the buffer's target
+    void BindBase(unsigned int index) const;
+    void BindBase(unsigned int target, unsigned int index) const;
+
+    void SetSubData(unsigned int offset, unsigned int size, const void* data);
+
+    // hands the current storage back to the driver so rewriting the whole
+    // buffer does not wait for draws still reading it
+    void Orphan();
+
+    inline unsigned int GetRendererID() const
+    {
+        return _rendererID;
+    }
+
+    inline unsigned int GetSize() const
+    {
+        return _size;
+    }
+
+private:
+
+    unsigned int    _rendererID = 0;
+    unsigned int    _target     = 0;
+    unsigned int    _size       = 0;
+    unsigned int    _usage      = 0;
+};
+
+#endif // _gpubuffer_h_
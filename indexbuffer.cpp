@@ -1,5 +1,7 @@
 #include "renderer.h"
 #include "indexbuffer.h"
+#include "resourcememory.h"
+#include "glcapture.h"
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
@@ -9,6 +11,8 @@ IndexBuffer::IndexBuffer( const unsigned int* data, unsigned int count )
     glGenBuffers(1, &_rendererID);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _rendererID);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW);
+
+    ResourceMemory::Allocate(ResourceMemory::Category::IndexBuffer, count * sizeof(unsigned int));
 }
 
 // -----------------------------------------------------------------------------
@@ -16,13 +20,17 @@ IndexBuffer::IndexBuffer( const unsigned int* data, unsigned int count )
 IndexBuffer::~IndexBuffer()
 {
     glDeleteBuffers(1, &_rendererID);
+    GLCapture::DeleteBuffer(_rendererID);
+
+    ResourceMemory::Free(ResourceMemory::Category::IndexBuffer, _count * sizeof(unsigned int));
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void IndexBuffer::Bind() const
+void IndexBuffer::Bind(GLDebug::Caller caller) const
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _rendererID);
+    GLCallFrom(caller, glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _rendererID));
+    GLCapture::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, _rendererID);
 }
 
 // -----------------------------------------------------------------------------
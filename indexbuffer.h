@@ -1,6 +1,8 @@
 #ifndef _indexbuffer_h_
 #define _indexbuffer_h_
 
+#include "gldebug.h"
+
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 class IndexBuffer
@@ -10,7 +12,7 @@ public:
     IndexBuffer( const unsigned int* data, unsigned int count );
     ~IndexBuffer();
 
-    void Bind() const;
+    void Bind(GLDebug::Caller caller = {}) const;
     void Unbind() const;
 
     unsigned int GetCount() const;
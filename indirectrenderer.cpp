@@ -0,0 +1,220 @@
+#include "renderer.h"
+#include "indirectrenderer.h"
+#include "vertexbufferlayout.h"
+
+#include <cmath>
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "indirect commands must be tightly packed");
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+IndirectRenderer::IndirectRenderer()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+IndirectRenderer::~IndirectRenderer()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool IndirectRenderer::IsSupported()
+{
+    // the draw shader is #version 400 with storage buffers and explicit
+    // bindings from extensions, which GL 4.3 has in core
+    return GLEW_VERSION_4_3 || (GLEW_VERSION_4_0 &&
+                                GLEW_ARB_multi_draw_indirect &&
+                                GLEW_ARB_base_instance &&
+                                GLEW_ARB_shader_storage_buffer_object &&
+                                GLEW_ARB_shading_language_420pack);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool IndirectRenderer::IsComputeCullingSupported()
+{
+    // cull.shader is #version 430, older contexts cull on the CPU
+    return IsSupported() && GLEW_VERSION_4_3;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+unsigned int IndirectRenderer::AddMesh(const float* positions, unsigned int vertexCount,
+                                       const unsigned int* indices, unsigned int indexCount)
+{
+    MeshInfo mesh;
+    mesh.indexCount = indexCount;
+    mesh.firstIndex = (unsigned int)_indices.size();
+    mesh.baseVertex = (int)(_vertices.size() / 2);
+    mesh.radius     = 0.0f;
+
+    for ( unsigned int ii = 0; ii < vertexCount; ++ii )
+    {
+        float x = positions[2 * ii], y = positions[2 * ii + 1];
+        mesh.radius = std::fmax(mesh.radius, std::sqrt(x * x + y * y));
+        _vertices.push_back(x);
+        _vertices.push_back(y);
+    }
+
+    _indices.insert(_indices.end(), indices, indices + indexCount);
+    _meshes.push_back(mesh);
+
+    return (unsigned int)_meshes.size() - 1;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+unsigned int IndirectRenderer::AddObject(unsigned int mesh, const glm::vec3& position, float scale,
+                                         const glm::vec4& color)
+{
+    ObjectData object;
+    object.positionScale = glm::vec4(position, scale);
+    object.color         = color;
+    object.bounds        = glm::vec4(position, _meshes[mesh].radius * scale);
+    object.mesh          = mesh;
+    object.padding[0] = object.padding[1] = object.padding[2] = 0;
+    _objects.push_back(object);
+
+    return (unsigned int)_objects.size() - 1;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void IndirectRenderer::Build()
+{
+    _vbo = std::make_unique<VertexBuffer>(_vertices.data(), (unsigned int)(_vertices.size() * sizeof(float)));
+    _ibo = std::make_unique<IndexBuffer>(_indices.data(), (unsigned int)_indices.size());
+
+    // per instance object index, baseInstance of each command selects the
+    // object so the vertex shader can fetch its data
+    std::vector<unsigned int> drawIDs(_objects.size());
+    for ( unsigned int ii = 0; ii < drawIDs.size(); ++ii )
+        drawIDs[ii] = ii;
+    _drawIDs = std::make_unique<VertexBuffer>(drawIDs.data(), (unsigned int)(drawIDs.size() * sizeof(unsigned int)));
+
+    _vao = std::make_unique<VertexArray>();
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    _vao->AddBuffer(*_vbo, layout);
+
+    VertexBufferLayout instanceLayout;
+    instanceLayout.Push<unsigned int>(1);
+    _vao->AddBuffer(*_drawIDs, instanceLayout, 1, 1);
+    _vao->Unbind();
+
+    _commands.resize(_objects.size());
+    for ( unsigned int ii = 0; ii < _objects.size(); ++ii )
+    {
+        const MeshInfo& mesh = _meshes[_objects[ii].mesh];
+        _commands[ii] = { mesh.indexCount, 1, mesh.firstIndex, mesh.baseVertex, ii };
+    }
+
+    _objectBuffer  = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, _objects.data(),
+                                                 (unsigned int)(_objects.size() * sizeof(ObjectData)), GL_STATIC_DRAW);
+    _meshBuffer    = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, _meshes.data(),
+                                                 (unsigned int)(_meshes.size() * sizeof(MeshInfo)), GL_STATIC_DRAW);
+    _commandBuffer = std::make_unique<GpuBuffer>(GL_DRAW_INDIRECT_BUFFER, _commands.data(),
+                                                 (unsigned int)(_commands.size() * sizeof(DrawElementsIndirectCommand)), GL_DYNAMIC_DRAW);
+
+    _drawShader = std::make_unique<Shader>("res/shaders/indirect.shader");
+    if ( IsComputeCullingSupported() )
+    {
+        _cullShader = std::make_unique<Shader>("res/shaders/cull.shader");
+        _computeCulling = _cullShader->IsValid();
+    }
+
+    // cpu side geometry is not needed anymore
+    _vertices = std::vector<float>();
+    _indices  = std::vector<unsigned int>();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void IndirectRenderer::SetComputeCulling(bool enable)
+{
+    _computeCulling = enable && _cullShader && _cullShader->IsValid();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void IndirectRenderer::ExtractFrustumPlanes(const glm::mat4& m, glm::vec4 planes[6])
+{
+    // Gribb/Hartmann, planes are combinations of the rows of the matrix
+    glm::vec4 row[4];
+    for ( int rr = 0; rr < 4; ++rr )
+        row[rr] = glm::vec4(m[0][rr], m[1][rr], m[2][rr], m[3][rr]);
+
+    planes[0] = row[3] + row[0];
+    planes[1] = row[3] - row[0];
+    planes[2] = row[3] + row[1];
+    planes[3] = row[3] - row[1];
+    planes[4] = row[3] + row[2];
+    planes[5] = row[3] - row[2];
+
+    for ( int ii = 0; ii < 6; ++ii )
+    {
+        float length = std::sqrt(planes[ii].x * planes[ii].x + planes[ii].y * planes[ii].y + planes[ii].z * planes[ii].z);
+        planes[ii] = planes[ii] / length;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void IndirectRenderer::CullOnCpu(const glm::vec4 planes[6])
+{
+    _visibleCount = 0;
+    for ( unsigned int ii = 0; ii < _objects.size(); ++ii )
+    {
+        const glm::vec4& bounds = _objects[ii].bounds;
+        bool visible = true;
+        for ( int pp = 0; pp < 6 && visible; ++pp )
+        {
+            const glm::vec4& plane = planes[pp];
+            visible = plane.x * bounds.x + plane.y * bounds.y + plane.z * bounds.z + plane.w >= -bounds.w;
+        }
+
+        _commands[ii].instanceCount = visible ? 1 : 0;
+        _visibleCount += visible ? 1 : 0;
+    }
+
+    _commandBuffer->SetSubData(0, (unsigned int)(_commands.size() * sizeof(DrawElementsIndirectCommand)), _commands.data());
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void IndirectRenderer::Draw(const glm::mat4& viewProj)
+{
+    if ( _objects.empty() || !_drawShader )
+        return;
+
+    glm::vec4 planes[6];
+    ExtractFrustumPlanes(viewProj, planes);
+
+    unsigned int objectCount = (unsigned int)_objects.size();
+    if ( _computeCulling )
+    {
+        _cullShader->Bind();
+        _cullShader->SetUniform4fv("u_Planes", 6, &planes[0].x);
+        _cullShader->SetUniform1ui("u_ObjectCount", objectCount);
+        _objectBuffer->BindBase(0);
+        _meshBuffer->BindBase(1);
+        _commandBuffer->BindBase(GL_SHADER_STORAGE_BUFFER, 2);
+        GLCall(glDispatchCompute((objectCount + 63) / 64, 1, 1));
+        GLCall(glMemoryBarrier(GL_COMMAND_BARRIER_BIT));
+    }
+    else
+    {
+        CullOnCpu(planes);
+    }
+
+    _drawShader->Bind();
+    _drawShader->SetUniformMat4f("u_ViewProj", viewProj);
+    _objectBuffer->BindBase(0);
+    _vao->Bind();
+    _ibo->Bind();
+    _commandBuffer->Bind();
+    GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, objectCount, 0));
+    _commandBuffer->Unbind();
+}
@@ -0,0 +1,117 @@
+#ifndef _indirectrenderer_h_
+#define _indirectrenderer_h_
+
+#include "vertexarray.h"
+#include "vertexbuffer.h"
+#include "indexbuffer.h"
+#include "gpubuffer.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Layout of the records consumed by glMultiDrawElementsIndirect.
+// -----------------------------------------------------------------------------
+struct DrawElementsIndirectCommand
+{
+    unsigned int    count;
+    unsigned int    instanceCount;
+    unsigned int    firstIndex;
+    int             baseVertex;
+    unsigned int    baseInstance;
+};
+
+// -----------------------------------------------------------------------------
+// GPU driven path for static meshes. All meshes share one vertex and one index
+// buffer, per object data lives in a storage buffer and every frame is
+// submitted with a single glMultiDrawElementsIndirect. Culling writes one
+// command per object (zero instances when culled), on the GPU with a compute
+// shader when available or on the CPU otherwise.
+// -----------------------------------------------------------------------------
+class IndirectRenderer
+{
+public:
+
+    IndirectRenderer();
+    ~IndirectRenderer();
+
+    static bool IsSupported();
+    static bool IsComputeCullingSupported();
+
+    // positions are 2d, returns the mesh index
+    unsigned int AddMesh(const float* positions, unsigned int vertexCount,
+                         const unsigned int* indices, unsigned int indexCount);
+
+    unsigned int AddObject(unsigned int mesh, const glm::vec3& position, float scale,
+                           const glm::vec4& color);
+
+    // uploads everything added so far, meshes and objects are static after
+    void Build();
+
+    void SetComputeCulling(bool enable);
+    inline bool GetComputeCulling() const
+    {
+        return _computeCulling;
+    }
+
+    void Draw(const glm::mat4& viewProj);
+
+    // only known when culling ran on the CPU
+    inline unsigned int GetVisibleCount() const
+    {
+        return _visibleCount;
+    }
+
+    inline unsigned int GetObjectCount() const
+    {
+        return (unsigned int)_objects.size();
+    }
+
+    static void ExtractFrustumPlanes(const glm::mat4& viewProj, glm::vec4 planes[6]);
+
+private:
+
+    // std430 layouts shared with the shaders
+    struct ObjectData
+    {
+        glm::vec4       positionScale;
+        glm::vec4       color;
+        glm::vec4       bounds;
+        unsigned int    mesh;
+        unsigned int    padding[3];
+    };
+
+    struct MeshInfo
+    {
+        unsigned int    indexCount;
+        unsigned int    firstIndex;
+        int             baseVertex;
+        float           radius;
+    };
+
+    void CullOnCpu(const glm::vec4 planes[6]);
+
+    std::vector<float>                          _vertices;
+    std::vector<unsigned int>                   _indices;
+    std::vector<MeshInfo>                       _meshes;
+    std::vector<ObjectData>                     _objects;
+    std::vector<DrawElementsIndirectCommand>    _commands;
+
+    std::unique_ptr<VertexArray>    _vao;
+    std::unique_ptr<VertexBuffer>   _vbo;
+    std::unique_ptr<VertexBuffer>   _drawIDs;
+    std::unique_ptr<IndexBuffer>    _ibo;
+    std::unique_ptr<GpuBuffer>      _objectBuffer;
+    std::unique_ptr<GpuBuffer>      _meshBuffer;
+    std::unique_ptr<GpuBuffer>      _commandBuffer;
+    std::unique_ptr<Shader>         _drawShader;
+    std::unique_ptr<Shader>         _cullShader;
+
+    bool                            _computeCulling = false;
+    unsigned int                    _visibleCount   = 0;
+};
+
+#endif // _indirectrenderer_h_
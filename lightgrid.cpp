@@ -0,0 +1,359 @@
+#include "renderer.h"
+#include "lightgrid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define LIGHTGRID_X86
+    #include <emmintrin.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t LightSoA::Add(const glm::vec2& position, float lightRadius, const glm::vec3& color)
+{
+    size_t index = GetCount();
+    px.push_back(position.x); py.push_back(position.y); radius.push_back(lightRadius);
+    r.push_back(color.x); g.push_back(color.y); b.push_back(color.z);
+    return index;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightSoA::SetPosition(size_t index, const glm::vec2& position)
+{
+    px[index] = position.x; py[index] = position.y;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightSoA::Reserve(size_t count)
+{
+    px.reserve(count); py.reserve(count); radius.reserve(count);
+    r.reserve(count); g.reserve(count); b.reserve(count);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightSoA::Clear()
+{
+    px.clear(); py.clear(); radius.clear();
+    r.clear(); g.clear(); b.clear();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+LightGrid::LightGrid(unsigned int tileSize)
+    : _tileSize(tileSize),
+      _simd(IsSimdSupported())
+{
+    _lightBuffer.format = GL_RGBA32F;
+    _rangeBuffer.format = GL_RG32UI;
+    _indexBuffer.format = GL_R16UI;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+LightGrid::~LightGrid()
+{
+    GLCall(glDeleteTextures(1, &_lightBuffer.texture));
+    GLCall(glDeleteTextures(1, &_rangeBuffer.texture));
+    GLCall(glDeleteTextures(1, &_indexBuffer.texture));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool LightGrid::IsSimdSupported()
+{
+#ifdef LIGHTGRID_X86
+    return true;
+#else
+    return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightGrid::Build(const LightSoA& lights, const glm::mat4& viewProj, bool bin)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    GLint viewport[4];
+    GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+    _origin[0] = viewport[0];
+    _origin[1] = viewport[1];
+
+    auto start = Clock::now();
+
+    size_t count = std::min(lights.GetCount(), (size_t)65536);
+    _lightCount = (unsigned int)count;
+    Project(lights, viewProj, (float)viewport[2], (float)viewport[3]);
+
+    _stats.tilesX = ((unsigned int)viewport[2] + _tileSize - 1) / _tileSize;
+    _stats.tilesY = ((unsigned int)viewport[3] + _tileSize - 1) / _tileSize;
+
+    _hitTiles.clear();
+    _hitLights.clear();
+    if ( bin )
+    {
+        if ( _simd )
+            BinSSE(count);
+        else
+            BinScalar(count);
+        Sort();
+    }
+
+    auto binned = Clock::now();
+
+    Upload(_lightBuffer, _lightData.data(), _lightData.size() * sizeof(float));
+    if ( bin )
+    {
+        Upload(_rangeBuffer, _tileRanges.data(), _tileRanges.size() * sizeof(uint32_t));
+        Upload(_indexBuffer, _indices.data(), _indices.size() * sizeof(uint16_t));
+    }
+
+    _stats.indices = bin ? (unsigned int)_indices.size() : 0;
+    _stats.binMs = std::chrono::duration<double, std::milli>(binned - start).count();
+    _stats.uploadMs = std::chrono::duration<double, std::milli>(Clock::now() - binned).count();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightGrid::Project(const LightSoA& lights, const glm::mat4& viewProj, float width, float height)
+{
+    size_t count = _lightCount;
+    _cx.resize(count); _cy.resize(count); _rx.resize(count); _ry.resize(count);
+
+    // clip space to pixels folded into the affine part of the matrix
+    float halfWidth = 0.5f * width, halfHeight = 0.5f * height;
+    float ax = viewProj[0][0] * halfWidth, bx = viewProj[1][0] * halfWidth, cx = (viewProj[3][0] + 1.0f) * halfWidth;
+    float ay = viewProj[0][1] * halfHeight, by = viewProj[1][1] * halfHeight, cy = (viewProj[3][1] + 1.0f) * halfHeight;
+    float kx = std::fabs(ax), ky = std::fabs(by);
+
+    size_t ii = 0;
+#ifdef LIGHTGRID_X86
+    if ( _simd )
+    {
+        __m128 vax = _mm_set1_ps(ax), vbx = _mm_set1_ps(bx), vcx = _mm_set1_ps(cx);
+        __m128 vay = _mm_set1_ps(ay), vby = _mm_set1_ps(by), vcy = _mm_set1_ps(cy);
+        __m128 vkx = _mm_set1_ps(kx), vky = _mm_set1_ps(ky);
+
+        for ( ; ii + 4 <= count; ii += 4 )
+        {
+            __m128 x = _mm_loadu_ps(&lights.px[ii]);
+            __m128 y = _mm_loadu_ps(&lights.py[ii]);
+            __m128 radius = _mm_loadu_ps(&lights.radius[ii]);
+            _mm_storeu_ps(&_cx[ii], _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, vax), _mm_mul_ps(y, vbx)), vcx));
+            _mm_storeu_ps(&_cy[ii], _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, vay), _mm_mul_ps(y, vby)), vcy));
+            _mm_storeu_ps(&_rx[ii], _mm_mul_ps(radius, vkx));
+            _mm_storeu_ps(&_ry[ii], _mm_mul_ps(radius, vky));
+        }
+    }
+#endif
+    for ( ; ii < count; ++ii )
+    {
+        _cx[ii] = lights.px[ii] * ax + lights.py[ii] * bx + cx;
+        _cy[ii] = lights.px[ii] * ay + lights.py[ii] * by + cy;
+        _rx[ii] = lights.radius[ii] * kx;
+        _ry[ii] = lights.radius[ii] * ky;
+    }
+
+    _lightData.resize(count * 8);
+    for ( ii = 0; ii < count; ++ii )
+    {
+        float* data = &_lightData[ii * 8];
+        data[0] = _cx[ii];
+        data[1] = _cy[ii];
+        data[2] = _rx[ii] > 0.0f ? 1.0f / _rx[ii] : 0.0f;
+        data[3] = _ry[ii] > 0.0f ? 1.0f / _ry[ii] : 0.0f;
+        data[4] = lights.r[ii];
+        data[5] = lights.g[ii];
+        data[6] = lights.b[ii];
+        data[7] = 0.0f;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightGrid::BinScalar(size_t count)
+{
+    const float tile = (float)_tileSize;
+    const int lastX = (int)_stats.tilesX - 1, lastY = (int)_stats.tilesY - 1;
+
+    for ( size_t ll = 0; ll < count; ++ll )
+    {
+        float cx = _cx[ll], cy = _cy[ll], rx = _rx[ll], ry = _ry[ll];
+        int x0 = std::max(0, (int)std::floor((cx - rx) / tile)), x1 = std::min(lastX, (int)std::floor((cx + rx) / tile));
+        int y0 = std::max(0, (int)std::floor((cy - ry) / tile)), y1 = std::min(lastY, (int)std::floor((cy + ry) / tile));
+        if ( x0 > x1 || y0 > y1 || rx <= 0.0f || ry <= 0.0f )
+            continue;
+
+        // distance from the centre to the closest point of the tile, in
+        // units of the radii, is below one when the ellipse touches it
+        float invRx = 1.0f / rx, invRy = 1.0f / ry;
+        for ( int ty = y0; ty <= y1; ++ty )
+        {
+            float bottom = ty * tile;
+            float dy = (cy - std::min(std::max(cy, bottom), bottom + tile)) * invRy;
+            float dy2 = dy * dy;
+            if ( dy2 > 1.0f )
+                continue;
+
+            for ( int tx = x0; tx <= x1; ++tx )
+            {
+                float left = tx * tile;
+                float dx = (cx - std::min(std::max(cx, left), left + tile)) * invRx;
+                if ( dx * dx + dy2 <= 1.0f )
+                {
+                    _hitTiles.push_back((uint32_t)(ty * (int)_stats.tilesX + tx));
+                    _hitLights.push_back((uint16_t)ll);
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightGrid::BinSSE(size_t count)
+{
+#ifdef LIGHTGRID_X86
+    // same test as BinScalar, four tiles of a row at a time
+    const float tile = (float)_tileSize;
+    const int lastX = (int)_stats.tilesX - 1, lastY = (int)_stats.tilesY - 1;
+    const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 vtile = _mm_set1_ps(tile);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for ( size_t ll = 0; ll < count; ++ll )
+    {
+        float cx = _cx[ll], cy = _cy[ll], rx = _rx[ll], ry = _ry[ll];
+        int x0 = std::max(0, (int)std::floor((cx - rx) / tile)), x1 = std::min(lastX, (int)std::floor((cx + rx) / tile));
+        int y0 = std::max(0, (int)std::floor((cy - ry) / tile)), y1 = std::min(lastY, (int)std::floor((cy + ry) / tile));
+        if ( x0 > x1 || y0 > y1 || rx <= 0.0f || ry <= 0.0f )
+            continue;
+
+        float invRy = 1.0f / ry;
+        __m128 vcx = _mm_set1_ps(cx);
+        __m128 vinvRx = _mm_set1_ps(1.0f / rx);
+
+        for ( int ty = y0; ty <= y1; ++ty )
+        {
+            float bottom = ty * tile;
+            float dy = (cy - std::min(std::max(cy, bottom), bottom + tile)) * invRy;
+            float dy2 = dy * dy;
+            if ( dy2 > 1.0f )
+                continue;
+
+            __m128 vdy2 = _mm_set1_ps(dy2);
+            uint32_t row = (uint32_t)(ty * (int)_stats.tilesX);
+
+            for ( int tx = x0; tx <= x1; tx += 4 )
+            {
+                __m128 left = _mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)tx), lanes), vtile);
+                __m128 closest = _mm_min_ps(_mm_max_ps(vcx, left), _mm_add_ps(left, vtile));
+                __m128 dx = _mm_mul_ps(_mm_sub_ps(vcx, closest), vinvRx);
+                __m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), vdy2);
+
+                int mask = _mm_movemask_ps(_mm_cmple_ps(distance, one));
+                int remaining = x1 - tx + 1;
+                if ( remaining < 4 )
+                    mask &= (1 << remaining) - 1;
+
+                for ( int lane = 0; mask; ++lane, mask >>= 1 )
+                {
+                    if ( mask & 1 )
+                    {
+                        _hitTiles.push_back(row + (uint32_t)(tx + lane));
+                        _hitLights.push_back((uint16_t)ll);
+                    }
+                }
+            }
+        }
+    }
+#else
+    BinScalar(count);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightGrid::Sort()
+{
+    // counting sort by tile, hits come in light order so every tile list
+    // stays sorted by light
+    size_t tiles = (size_t)_stats.tilesX * _stats.tilesY;
+    _tileRanges.assign(tiles * 2, 0);
+    for ( uint32_t tile : _hitTiles )
+        ++_tileRanges[tile * 2 + 1];
+
+    _cursor.resize(tiles);
+    uint32_t offset = 0, maxPerTile = 0;
+    for ( size_t tt = 0; tt < tiles; ++tt )
+    {
+        _tileRanges[tt * 2] = offset;
+        _cursor[tt] = offset;
+        offset += _tileRanges[tt * 2 + 1];
+        maxPerTile = std::max(maxPerTile, _tileRanges[tt * 2 + 1]);
+    }
+
+    _indices.resize(_hitTiles.size());
+    for ( size_t hh = 0; hh < _hitTiles.size(); ++hh )
+        _indices[_cursor[_hitTiles[hh]]++] = _hitLights[hh];
+
+    _stats.maxPerTile = maxPerTile;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightGrid::Upload(TextureBuffer& target, const void* data, size_t size)
+{
+    if ( !target.buffer || target.buffer->GetSize() < size )
+    {
+        unsigned int capacity = 4096;
+        if ( target.buffer )
+            capacity = target.buffer->GetSize();
+        while ( capacity < size )
+            capacity *= 2;
+
+        target.buffer = std::make_unique<GpuBuffer>(GL_TEXTURE_BUFFER, nullptr, capacity, GL_STREAM_DRAW);
+
+        if ( !target.texture )
+            GLCall(glGenTextures(1, &target.texture));
+        GLCall(glBindTexture(GL_TEXTURE_BUFFER, target.texture));
+        GLCall(glTexBuffer(GL_TEXTURE_BUFFER, target.format, target.buffer->GetRendererID()));
+        GLCall(glBindTexture(GL_TEXTURE_BUFFER, 0));
+    }
+    else
+    {
+        target.buffer->Orphan();
+    }
+
+    if ( size > 0 )
+        target.buffer->SetSubData(0, (unsigned int)size, data);
+    target.buffer->Unbind();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void LightGrid::Bind(Shader& shader, unsigned int firstSlot) const
+{
+    const TextureBuffer* buffers[] = { &_lightBuffer, &_rangeBuffer, &_indexBuffer };
+    const char* names[] = { "u_Lights", "u_TileRanges", "u_LightIndices" };
+
+    shader.Bind();
+    for ( unsigned int ii = 0; ii < 3; ++ii )
+    {
+        GLCall(glActiveTexture(GL_TEXTURE0 + firstSlot + ii));
+        GLCall(glBindTexture(GL_TEXTURE_BUFFER, buffers[ii]->texture));
+        shader.SetUniform1i(names[ii], (int)(firstSlot + ii));
+    }
+    GLCall(glActiveTexture(GL_TEXTURE0));
+
+    shader.SetUniform1i("u_LightCount", (int)_lightCount);
+    shader.SetUniform1i("u_TileSize", (int)_tileSize);
+    shader.SetUniform1i("u_TilesX", (int)_stats.tilesX);
+    shader.SetUniform2f("u_GridOrigin", (float)_origin[0], (float)_origin[1]);
+}
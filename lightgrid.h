@@ -0,0 +1,133 @@
+#ifndef _lightgrid_h_
+#define _lightgrid_h_
+
+#include "gpubuffer.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Point lights stored as one array per component so the grid can project
+// several of them per SIMD instruction.
+// -----------------------------------------------------------------------------
+struct LightSoA
+{
+    size_t Add(const glm::vec2& position, float radius, const glm::vec3& color);
+    void SetPosition(size_t index, const glm::vec2& position);
+    void Reserve(size_t count);
+    void Clear();
+
+    inline size_t GetCount() const
+    {
+        return px.size();
+    }
+
+    std::vector<float>  px, py, radius;
+    std::vector<float>  r, g, b;
+};
+
+// -----------------------------------------------------------------------------
+// Screen space light tiles. Build projects the lights into the viewport that
+// is bound at the time, tests every light against the tiles its bounds touch
+// and sorts the hits into one index list per tile. The lights, the per tile
+// (offset, count) ranges and the index list go to texture buffers, so the
+// fragment shader only loops over the lights of its own tile. The view
+// projection has to be affine, as for the 2D scenes, and at most 65536 lights
+// are indexed.
+// -----------------------------------------------------------------------------
+class LightGrid
+{
+public:
+
+    struct Stats
+    {
+        unsigned int    tilesX          = 0;
+        unsigned int    tilesY          = 0;
+        unsigned int    indices         = 0;
+        unsigned int    maxPerTile      = 0;
+        double          binMs           = 0.0;
+        double          uploadMs        = 0.0;
+    };
+
+    explicit LightGrid(unsigned int tileSize = 32);
+    ~LightGrid();
+
+    inline void SetTileSize(unsigned int tileSize)
+    {
+        _tileSize = tileSize;
+    }
+
+    inline unsigned int GetTileSize() const
+    {
+        return _tileSize;
+    }
+
+    // SSE projection and tile tests, ignored where the cpu has no SSE
+    inline void SetSimd(bool simd)
+    {
+        _simd = simd && IsSimdSupported();
+    }
+
+    inline bool IsSimd() const
+    {
+        return _simd;
+    }
+
+    static bool IsSimdSupported();
+
+    // without binning only the lights are uploaded, for the brute force path
+    void Build(const LightSoA& lights, const glm::mat4& viewProj, bool bin = true);
+
+    // binds the texture buffers to slots [firstSlot, firstSlot + 3) and sets
+    // the grid uniforms of the lit shader
+    void Bind(Shader& shader, unsigned int firstSlot) const;
+
+    inline const Stats& GetStats() const
+    {
+        return _stats;
+    }
+
+private:
+
+    struct TextureBuffer
+    {
+        std::unique_ptr<GpuBuffer>  buffer;
+        unsigned int                texture = 0;
+        unsigned int                format  = 0;
+    };
+
+    void Project(const LightSoA& lights, const glm::mat4& viewProj, float width, float height);
+    void BinScalar(size_t count);
+    void BinSSE(size_t count);
+    void Sort();
+    static void Upload(TextureBuffer& target, const void* data, size_t size);
+
+    unsigned int            _tileSize   = 32;
+    bool                    _simd       = true;
+    int                     _origin[2]  = {};
+    unsigned int            _lightCount = 0;
+
+    // lights in pixels relative to the viewport origin
+    std::vector<float>      _cx, _cy, _rx, _ry;
+    std::vector<float>      _lightData;     // centre, inverse radii, then color
+
+    // (tile, light) hits in light order, sorted into ranges per tile
+    std::vector<uint32_t>   _hitTiles;
+    std::vector<uint16_t>   _hitLights;
+    std::vector<uint32_t>   _tileRanges;
+    std::vector<uint32_t>   _cursor;
+    std::vector<uint16_t>   _indices;
+
+    TextureBuffer           _lightBuffer;
+    TextureBuffer           _rangeBuffer;
+    TextureBuffer           _indexBuffer;
+
+    Stats                   _stats;
+};
+
+#endif // _lightgrid_h_
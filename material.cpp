@@ -0,0 +1,49 @@
+#include "material.h"
+#include "shader.h"
+#include "texture.h"
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Material::Material( Shader& shader, const Texture& texture, const glm::vec4& tint )
+    : _shader(&shader),
+      _texture(&texture),
+      _tint(tint),
+      _blendMode(Classify(texture, tint))
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+BlendMode Material::Classify(const Texture& texture, const glm::vec4& tint)
+{
+    if ( tint.w < 1.0f )
+        return BlendMode::Translucent;
+
+    switch ( texture.GetAlphaUsage() )
+    {
+        case Texture::AlphaUsage::Opaque:       return BlendMode::Opaque;
+        case Texture::AlphaUsage::Masked:       return BlendMode::Masked;
+        case Texture::AlphaUsage::Translucent:  return BlendMode::Translucent;
+    }
+
+    return BlendMode::Translucent;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Material::SetTint(const glm::vec4& tint)
+{
+    _tint = tint;
+    _blendMode = Classify(*_texture, tint);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Material::Bind() const
+{
+    _shader->Bind();
+    _texture->Bind(0);
+    _shader->SetUniform1i("u_Texture", 0);
+    _shader->SetUniform4f("u_Tint", _tint.x, _tint.y, _tint.z, _tint.w);
+    _shader->SetUniform1f("u_AlphaCutoff", GetAlphaCutoff());
+}
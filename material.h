@@ -0,0 +1,70 @@
+#ifndef _material_h_
+#define _material_h_
+
+#include <glm/glm.hpp>
+
+class Shader;
+class Texture;
+
+// -----------------------------------------------------------------------------
+// How a material is composited, picks the render queue pass it is drawn in.
+// -----------------------------------------------------------------------------
+enum class BlendMode
+{
+    Opaque,         // depth tested and written, no blending
+    Masked,         // as opaque, fragments under the alpha cutoff are discarded
+    Translucent     // blended back to front, depth tested but not written
+};
+
+// -----------------------------------------------------------------------------
+// A shader, a texture and a tint. The blend mode is classified from the alpha
+// of the texture and the tint so only what really needs blending is blended.
+// -----------------------------------------------------------------------------
+class Material
+{
+public:
+
+    Material( Shader& shader, const Texture& texture, const glm::vec4& tint = glm::vec4(1.0f) );
+
+    static BlendMode Classify(const Texture& texture, const glm::vec4& tint);
+
+    // binds the shader and texture and sets u_Texture, u_Tint and u_AlphaCutoff
+    void Bind() const;
+
+    void SetTint(const glm::vec4& tint);
+
+    // overrides the classified mode, the next SetTint classifies again
+    inline void SetBlendMode(BlendMode mode)
+    {
+        _blendMode = mode;
+    }
+
+    inline BlendMode GetBlendMode() const
+    {
+        return _blendMode;
+    }
+
+    inline float GetAlphaCutoff() const
+    {
+        return _blendMode == BlendMode::Masked ? 0.5f : -1.0f;
+    }
+
+    inline Shader& GetShader() const
+    {
+        return *_shader;
+    }
+
+    inline const Texture& GetTexture() const
+    {
+        return *_texture;
+    }
+
+private:
+
+    Shader*         _shader;
+    const Texture*  _texture;
+    glm::vec4       _tint;
+    BlendMode       _blendMode;
+};
+
+#endif // _material_h_
@@ -0,0 +1,280 @@
+#include "renderer.h"
+#include "overlaycompositor.h"
+#include "vertexbufferlayout.h"
+
+#include <imgui.h>
+#include <imgui_impl_opengl3.h>
+
+#include <chrono>
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for ( size_t ii = 0; ii < size; ++ii )
+    {
+        hash ^= bytes[ii];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+template <typename T>
+uint64_t HashValue(const T& value, uint64_t hash)
+{
+    return HashBytes(&value, sizeof(T), hash);
+}
+
+// exponential moving average weight of the newest sample
+const double s_smoothing = 0.05;
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+OverlayCompositor::OverlayCompositor()
+{
+    float positions[] = { -1.0f, -1.0f, 0.0f, 0.0f,
+                           1.0f, -1.0f, 1.0f, 0.0f,
+                           1.0f,  1.0f, 1.0f, 1.0f,
+                          -1.0f,  1.0f, 0.0f, 1.0f };
+
+    unsigned int indices[] = { 0, 1, 2,
+                               2, 3, 0 };
+
+    _vao = std::make_unique<VertexArray>();
+    _vbo = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    _vao->AddBuffer(*_vbo, layout);
+
+    _ibo = std::make_unique<IndexBuffer>(indices, 6);
+
+    _shader = std::make_unique<Shader>("res/shaders/composite.shader");
+    _shader->Bind();
+    _shader->SetUniform1i("u_Texture", 0);
+
+    glGenQueries(s_queryCount, _queries);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+OverlayCompositor::~OverlayCompositor()
+{
+    glDeleteQueries(s_queryCount, _queries);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint64_t OverlayCompositor::Hash(const ImDrawData* drawData)
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashValue(drawData->DisplaySize.x, hash);
+    hash = HashValue(drawData->DisplaySize.y, hash);
+    hash = HashValue(drawData->CmdListsCount, hash);
+
+    for ( int ll = 0; ll < drawData->CmdListsCount; ++ll )
+    {
+        const ImDrawList* list = drawData->CmdLists[ll];
+        hash = HashBytes(list->VtxBuffer.Data, (size_t)list->VtxBuffer.Size * sizeof(ImDrawVert), hash);
+        hash = HashBytes(list->IdxBuffer.Data, (size_t)list->IdxBuffer.Size * sizeof(ImDrawIdx), hash);
+
+        // field by field, the struct has padding
+        for ( const ImDrawCmd& cmd : list->CmdBuffer )
+        {
+            hash = HashValue(cmd.ElemCount, hash);
+            hash = HashValue(cmd.ClipRect, hash);
+            hash = HashValue(cmd.TextureId, hash);
+            hash = HashValue(cmd.VtxOffset, hash);
+            hash = HashValue(cmd.IdxOffset, hash);
+            hash = HashValue(cmd.UserCallback, hash);
+            hash = HashValue(cmd.UserCallbackData, hash);
+        }
+    }
+
+    return hash;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool OverlayCompositor::HasInput()
+{
+    const ImGuiIO& io = ImGui::GetIO();
+    if ( io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f )
+        return true;
+
+    if ( io.MouseWheel != 0.0f || io.MouseWheelH != 0.0f || io.InputQueueCharacters.Size > 0 )
+        return true;
+
+    for ( bool down : io.MouseDown )
+    {
+        if ( down )
+            return true;
+    }
+
+    for ( bool down : io.KeysDown )
+    {
+        if ( down )
+            return true;
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void OverlayCompositor::SetupBlending(const ImDrawList* list, const ImDrawCmd* cmd)
+{
+    // the backend blends alpha like color, which would square the coverage in
+    // the cleared target; accumulate premultiplied alpha instead
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void OverlayCompositor::Redraw(ImDrawData* drawData, int width, int height)
+{
+    if ( !_target )
+        _target = std::make_unique<Framebuffer>(width, height);
+    else
+        _target->Resize(width, height);
+
+    _target->Bind();
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // runs after the backend sets up its render state, before any draw
+    if ( drawData->CmdListsCount > 0 )
+    {
+        ImDrawCmd setup;
+        setup.UserCallback = SetupBlending;
+        drawData->CmdLists[0]->CmdBuffer.push_front(setup);
+    }
+
+    ImGui_ImplOpenGL3_RenderDrawData(drawData);
+    _target->Unbind();
+    glViewport(0, 0, width, height);
+
+    ++_redraws;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void OverlayCompositor::Composite(int width, int height)
+{
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    _target->BindTexture(0);
+    _shader->Bind();
+    _vao->Bind();
+    _ibo->Bind();
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void OverlayCompositor::ReadQueries()
+{
+    // the oldest slot is the one about to be reused
+    unsigned int index = _frame % s_queryCount;
+    if ( !_queryIssued[index] )
+        return;
+
+    GLint available = 0;
+    glGetQueryObjectiv(_queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+    if ( available )
+    {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(_queries[index], GL_QUERY_RESULT, &nanoseconds);
+        Timing& timing = _timing[_queryMode[index]];
+        timing.gpuMs += (nanoseconds * 1e-6 - timing.gpuMs) * s_smoothing;
+    }
+
+    _queryIssued[index] = false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void OverlayCompositor::Render(ImDrawData* drawData)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    int width = (int)(drawData->DisplaySize.x * drawData->FramebufferScale.x);
+    int height = (int)(drawData->DisplaySize.y * drawData->FramebufferScale.y);
+    if ( width <= 0 || height <= 0 )
+        return;
+
+    ReadQueries();
+
+    unsigned int index = _frame % s_queryCount;
+    int mode = _enabled ? 1 : 0;
+    glBeginQuery(GL_TIME_ELAPSED, _queries[index]);
+
+    auto start = Clock::now();
+    double hashMs = 0.0;
+    if ( _enabled )
+    {
+        uint64_t hash = Hash(drawData);
+        hashMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        bool resized = !_target || _target->GetWidth() != width || _target->GetHeight() != height;
+        if ( !_valid || resized || hash != _lastHash || HasInput() )
+            Redraw(drawData, width, height);
+
+        _lastHash = hash;
+        _valid = true;
+        Composite(width, height);
+    }
+    else
+    {
+        ImGui_ImplOpenGL3_RenderDrawData(drawData);
+        ++_redraws;
+    }
+    double cpuMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    glEndQuery(GL_TIME_ELAPSED);
+    _queryIssued[index] = true;
+    _queryMode[index] = mode;
+    ++_frame;
+
+    Timing& timing = _timing[mode];
+    timing.cpuMs += (cpuMs - timing.cpuMs) * s_smoothing;
+    timing.hashMs += (hashMs - timing.hashMs) * s_smoothing;
+    ++_frames;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void OverlayCompositor::OnImGuiRender()
+{
+    bool enabled = _enabled;
+    if ( ImGui::Checkbox("Cache overlay", &enabled) )
+        SetEnabled(enabled);
+
+    // refresh twice a second so the numbers themselves do not force redraws
+    double now = ImGui::GetTime();
+    if ( now - _lastSample >= 0.5 )
+    {
+        _shown[0] = _timing[0];
+        _shown[1] = _timing[1];
+        _redrawRate = _frames ? 100.0f * _redraws / _frames : 0.0f;
+        _redraws = _frames = 0;
+        _lastSample = now;
+    }
+
+    ImGui::Text("Redrawn frames: %.0f%%", _redrawRate);
+    ImGui::Text("Direct:  CPU %.3f ms  GPU %.3f ms", _shown[0].cpuMs, _shown[0].gpuMs);
+    ImGui::Text("Cached:  CPU %.3f ms  GPU %.3f ms  (hash %.3f ms)", _shown[1].cpuMs, _shown[1].gpuMs,
+                _shown[1].hashMs);
+}
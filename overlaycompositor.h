@@ -0,0 +1,89 @@
+#ifndef _overlaycompositor_h_
+#define _overlaycompositor_h_
+
+#include "framebuffer.h"
+#include "vertexarray.h"
+#include "vertexbuffer.h"
+#include "indexbuffer.h"
+#include "shader.h"
+
+#include <cstdint>
+#include <memory>
+
+struct ImDrawData;
+struct ImDrawList;
+struct ImDrawCmd;
+
+// -----------------------------------------------------------------------------
+// Keeps the rendered ImGui overlay in an offscreen texture. The draw lists
+// are hashed every frame and only rendered again when the hash changes, the
+// size changes or input arrived; otherwise the cached texture is composited
+// with one quad and nothing is uploaded.
+// -----------------------------------------------------------------------------
+class OverlayCompositor
+{
+public:
+
+    OverlayCompositor();
+    ~OverlayCompositor();
+
+    // replaces ImGui_ImplOpenGL3_RenderDrawData
+    void Render(ImDrawData* drawData);
+
+    inline void SetEnabled(bool enable)
+    {
+        _enabled = enable;
+        _valid = false;
+    }
+
+    inline bool IsEnabled() const
+    {
+        return _enabled;
+    }
+
+    void OnImGuiRender();
+
+private:
+
+    struct Timing
+    {
+        double  cpuMs   = 0.0;
+        double  gpuMs   = 0.0;
+        double  hashMs  = 0.0;
+    };
+
+    static uint64_t Hash(const ImDrawData* drawData);
+    static bool HasInput();
+    static void SetupBlending(const ImDrawList* list, const ImDrawCmd* cmd);
+
+    void Redraw(ImDrawData* drawData, int width, int height);
+    void Composite(int width, int height);
+    void ReadQueries();
+
+    std::unique_ptr<Framebuffer>    _target;
+    std::unique_ptr<VertexArray>    _vao;
+    std::unique_ptr<VertexBuffer>   _vbo;
+    std::unique_ptr<IndexBuffer>    _ibo;
+    std::unique_ptr<Shader>         _shader;
+
+    uint64_t        _lastHash   = 0;
+    bool            _valid      = false;
+    bool            _enabled    = true;
+
+    // GL_TIME_ELAPSED results are read a few frames late
+    static constexpr unsigned int s_queryCount = 4;
+    unsigned int    _queries[s_queryCount]      = {};
+    int             _queryMode[s_queryCount]    = {};
+    bool            _queryIssued[s_queryCount]  = {};
+    unsigned int    _frame                      = 0;
+
+    // index 0 direct rendering, 1 cached overlay
+    Timing          _timing[2];
+    Timing          _shown[2];
+    unsigned int    _redraws        = 0;
+    unsigned int    _frames         = 0;
+    float           _redrawRate     = 0.0f;
+    double          _lastSample     = 0.0;
+};
+
+#endif // _overlaycompositor_h_
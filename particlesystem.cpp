@@ -0,0 +1,278 @@
+#include "renderer.h"
+#include "particlesystem.h"
+#include "vertexbufferlayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// Mirrors the Counters block of the compute shaders, the dispatch and draw
+// arguments are read straight from it by the indirect calls.
+// -----------------------------------------------------------------------------
+struct ParticleCounters
+{
+    int             alive[2];
+    int             dead;
+    int             pad;
+    unsigned int    dispatch[4];    // x, y, z, unused
+    unsigned int    draw[4];        // count, instanceCount, first, baseInstance
+};
+
+const unsigned int s_dispatchOffset = offsetof(ParticleCounters, dispatch);
+const unsigned int s_drawOffset     = offsetof(ParticleCounters, draw);
+const unsigned int s_groupSize      = 256;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void SetSpawnUniforms(Shader& shader, const ParticleSystem::Settings& settings, unsigned int seed)
+{
+    shader.SetUniform2f("u_Emitter", settings.emitter.x, settings.emitter.y);
+    shader.SetUniform1f("u_Spread", settings.spread);
+    shader.SetUniform1f("u_SpeedMin", settings.speedMin);
+    shader.SetUniform1f("u_SpeedMax", settings.speedMax);
+    shader.SetUniform1f("u_LifetimeMin", settings.lifetimeMin);
+    shader.SetUniform1f("u_LifetimeMax", settings.lifetimeMax);
+    shader.SetUniform1ui("u_Seed", seed);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void SetIntegrateUniforms(Shader& shader, const ParticleSystem::Settings& settings, float deltaTime)
+{
+    shader.SetUniform1f("u_DeltaTime", deltaTime);
+    shader.SetUniform2f("u_Gravity", settings.gravity.x, settings.gravity.y);
+    shader.SetUniform1f("u_Drag", settings.drag);
+}
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ParticleSystem::ParticleSystem(unsigned int capacity, Backend backend)
+    : _capacity(capacity),
+      _backend(backend)
+{
+    // triangle strip corners of the instanced quad
+    float corners[] = { -1.0f, -1.0f,
+                         1.0f, -1.0f,
+                        -1.0f,  1.0f,
+                         1.0f,  1.0f };
+    _corners = std::make_unique<VertexBuffer>(corners, (unsigned int)sizeof(corners));
+
+    if ( _backend == Backend::Compute && IsComputeSupported() )
+        CreateCompute();
+    else
+        CreateTransformFeedback();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ParticleSystem::~ParticleSystem()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool ParticleSystem::IsComputeSupported()
+{
+    // the compute and storage buffer draw shaders are #version 430
+    return GLEW_VERSION_4_3;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+float ParticleSystem::GetEmitRate() const
+{
+    return _capacity / std::max(_settings.lifetimeMax, 0.01f);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ParticleSystem::CreateTransformFeedback()
+{
+    _backend = Backend::TransformFeedback;
+
+    _updateShader = std::make_unique<Shader>("res/shaders/particle_update.shader");
+    _drawShader = std::make_unique<Shader>("res/shaders/particle.shader");
+
+    // position and velocity, age and lifetime; zero age and lifetime is dead
+    const unsigned int stride = 6u * (unsigned int)sizeof(float);
+    std::vector<float> zeros((size_t)_capacity * 6u, 0.0f);
+
+    VertexBufferLayout particleLayout;
+    particleLayout.Push<float>(4);
+    particleLayout.Push<float>(2);
+
+    VertexBufferLayout cornerLayout;
+    cornerLayout.Push<float>(2);
+
+    for ( int ii = 0; ii < 2; ++ii )
+    {
+        _particles[ii] = std::make_unique<VertexBuffer>(zeros.data(), _capacity * stride, GL_DYNAMIC_COPY);
+
+        _updateVao[ii] = std::make_unique<VertexArray>();
+        _updateVao[ii]->AddBuffer(*_particles[ii], particleLayout);
+
+        _drawVao[ii] = std::make_unique<VertexArray>();
+        _drawVao[ii]->AddBuffer(*_corners, cornerLayout);
+        _drawVao[ii]->AddBuffer(*_particles[ii], particleLayout, 1, 1);
+    }
+
+    _valid = _updateShader->IsValid() && _drawShader->IsValid();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ParticleSystem::CreateCompute()
+{
+    _emitShader = std::make_unique<Shader>("res/shaders/particle_emit.shader");
+    _simulateShader = std::make_unique<Shader>("res/shaders/particle_simulate.shader");
+    _finalizeShader = std::make_unique<Shader>("res/shaders/particle_finalize.shader");
+    _drawShader = std::make_unique<Shader>("res/shaders/particle_ssbo.shader");
+
+    _positions = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, nullptr, _capacity * 16u, GL_DYNAMIC_COPY);
+    _lifetimes = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, nullptr, _capacity * 8u, GL_DYNAMIC_COPY);
+    _alive[0] = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, nullptr, _capacity * 4u, GL_DYNAMIC_COPY);
+    _alive[1] = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, nullptr, _capacity * 4u, GL_DYNAMIC_COPY);
+
+    // every slot starts out dead
+    std::vector<unsigned int> dead(_capacity);
+    std::iota(dead.begin(), dead.end(), 0u);
+    _dead = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, dead.data(), _capacity * 4u, GL_DYNAMIC_COPY);
+
+    ParticleCounters counters = {};
+    counters.dead = (int)_capacity;
+    counters.dispatch[1] = counters.dispatch[2] = 1;
+    counters.draw[0] = 4;
+    _counters = std::make_unique<GpuBuffer>(GL_SHADER_STORAGE_BUFFER, &counters, (unsigned int)sizeof(counters),
+                                            GL_DYNAMIC_COPY);
+
+    // the draw shader builds its quads from gl_VertexID and storage buffers
+    _emptyVao = std::make_unique<VertexArray>();
+
+    _valid = _emitShader->IsValid() && _simulateShader->IsValid() && _finalizeShader->IsValid() &&
+             _drawShader->IsValid();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ParticleSystem::Update(float deltaTime)
+{
+    if ( !_valid )
+        return;
+
+    float emit = GetEmitRate() * deltaTime + _emitRemainder;
+    unsigned int emitCount = std::min((unsigned int)emit, _capacity);
+    _emitRemainder = emit - (float)emitCount;
+    ++_frame;
+
+    if ( _backend == Backend::Compute )
+        UpdateCompute(deltaTime, emitCount);
+    else
+        UpdateTransformFeedback(deltaTime, emitCount);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ParticleSystem::UpdateTransformFeedback(float deltaTime, unsigned int emitCount)
+{
+    unsigned int source = _current, target = 1 - _current;
+
+    _updateShader->Bind();
+    SetSpawnUniforms(*_updateShader, _settings, _frame * 0x9E3779B9u);
+    SetIntegrateUniforms(*_updateShader, _settings, deltaTime);
+    _updateShader->SetUniform1ui("u_Capacity", _capacity);
+    _updateShader->SetUniform1ui("u_EmitStart", _emitCursor);
+    _updateShader->SetUniform1ui("u_EmitCount", emitCount);
+
+    GLCall(glEnable(GL_RASTERIZER_DISCARD));
+    _updateVao[source]->Bind();
+    GLCall(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _particles[target]->GetRendererID()));
+    GLCall(glBeginTransformFeedback(GL_POINTS));
+    GLCall(glDrawArrays(GL_POINTS, 0, _capacity));
+    GLCall(glEndTransformFeedback());
+    GLCall(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0));
+    GLCall(glDisable(GL_RASTERIZER_DISCARD));
+
+    _emitCursor = (_emitCursor + emitCount) % _capacity;
+    _current = target;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ParticleSystem::UpdateCompute(float deltaTime, unsigned int emitCount)
+{
+    unsigned int source = _current, target = 1 - _current;
+
+    _positions->BindBase(0);
+    _lifetimes->BindBase(1);
+    _alive[source]->BindBase(2);
+    _alive[target]->BindBase(3);
+    _dead->BindBase(4);
+    _counters->BindBase(5);
+
+    // survivors of last frame, sized by last frame's finalize pass
+    _simulateShader->Bind();
+    SetIntegrateUniforms(*_simulateShader, _settings, deltaTime);
+    _simulateShader->SetUniform1i("u_In", (int)source);
+    GLCall(glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, _counters->GetRendererID()));
+    GLCall(glDispatchComputeIndirect(s_dispatchOffset));
+    GLCall(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+
+    if ( emitCount > 0 )
+    {
+        _emitShader->Bind();
+        SetSpawnUniforms(*_emitShader, _settings, _frame * 0x9E3779B9u);
+        _emitShader->SetUniform1i("u_In", (int)source);
+        _emitShader->SetUniform1ui("u_EmitCount", emitCount);
+        GLCall(glDispatchCompute((emitCount + s_groupSize - 1) / s_groupSize, 1, 1));
+        GLCall(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+    }
+
+    _finalizeShader->Bind();
+    _finalizeShader->SetUniform1i("u_In", (int)source);
+    GLCall(glDispatchCompute(1, 1, 1));
+    GLCall(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT));
+
+    _current = target;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ParticleSystem::Draw(const glm::mat4& viewProj)
+{
+    if ( !_valid )
+        return;
+
+    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE));
+
+    _drawShader->Bind();
+    _drawShader->SetUniformMat4f("u_MVP", viewProj);
+    _drawShader->SetUniform1f("u_Size", _settings.size);
+
+    if ( _backend == Backend::Compute )
+    {
+        _positions->BindBase(0);
+        _lifetimes->BindBase(1);
+        _alive[_current]->BindBase(2);
+        _emptyVao->Bind();
+        GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _counters->GetRendererID()));
+        GLCall(glDrawArraysIndirect(GL_TRIANGLE_STRIP, (const void*)(uintptr_t)s_drawOffset));
+        GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+    }
+    else
+    {
+        // dead particles collapse to a degenerate quad in the vertex shader
+        _drawVao[_current]->Bind();
+        GLCall(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, _capacity));
+    }
+
+    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+}
@@ -0,0 +1,118 @@
+#ifndef _particlesystem_h_
+#define _particlesystem_h_
+
+#include "vertexarray.h"
+#include "vertexbuffer.h"
+#include "gpubuffer.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+
+// -----------------------------------------------------------------------------
+// Fixed capacity particle system that emits, integrates, retires and draws
+// entirely on the GPU; the CPU only sets uniforms and issues the passes.
+//
+// TransformFeedback (GL 3.3) ping-pongs two vertex buffers through a vertex
+// shader with rasterization off. New particles are emitted into a ring of
+// slots that advances every frame, so no live counts are ever needed.
+//
+// Compute (GL 4.3) keeps a dead list and two alive lists in storage buffers.
+// Simulation compacts the survivors into the other alive list and pushes the
+// dead onto the dead list with atomics, emission pops from it, and a one
+// thread pass writes the indirect dispatch and draw arguments.
+// -----------------------------------------------------------------------------
+class ParticleSystem
+{
+public:
+
+    enum class Backend
+    {
+        TransformFeedback,
+        Compute
+    };
+
+    struct Settings
+    {
+        glm::vec2   emitter         = glm::vec2(480.0f, 120.0f);
+        float       spread          = 0.6f;        // radians around straight up
+        float       speedMin        = 150.0f;
+        float       speedMax        = 350.0f;
+        float       lifetimeMin     = 1.5f;
+        float       lifetimeMax     = 2.5f;
+        glm::vec2   gravity         = glm::vec2(0.0f, -150.0f);
+        float       drag            = 0.2f;
+        float       size            = 1.5f;
+    };
+
+    ParticleSystem(unsigned int capacity, Backend backend);
+    ~ParticleSystem();
+
+    static bool IsComputeSupported();
+
+    void Update(float deltaTime);
+    void Draw(const glm::mat4& viewProj);
+
+    inline Settings& GetSettings()
+    {
+        return _settings;
+    }
+
+    inline unsigned int GetCapacity() const
+    {
+        return _capacity;
+    }
+
+    inline Backend GetBackend() const
+    {
+        return _backend;
+    }
+
+    inline bool IsValid() const
+    {
+        return _valid;
+    }
+
+private:
+
+    // particles a second that keep the pool full without overwriting live ones
+    float GetEmitRate() const;
+
+    void CreateTransformFeedback();
+    void CreateCompute();
+    void UpdateTransformFeedback(float deltaTime, unsigned int emitCount);
+    void UpdateCompute(float deltaTime, unsigned int emitCount);
+
+    unsigned int    _capacity;
+    Backend         _backend;
+    Settings        _settings;
+    bool            _valid          = false;
+
+    float           _emitRemainder  = 0.0f;
+    unsigned int    _emitCursor     = 0;
+    unsigned int    _frame          = 0;
+    unsigned int    _current        = 0;
+
+    std::unique_ptr<Shader>         _drawShader;
+    std::unique_ptr<VertexBuffer>   _corners;
+
+    // transform feedback
+    std::unique_ptr<Shader>         _updateShader;
+    std::unique_ptr<VertexBuffer>   _particles[2];
+    std::unique_ptr<VertexArray>    _updateVao[2];
+    std::unique_ptr<VertexArray>    _drawVao[2];
+
+    // compute
+    std::unique_ptr<Shader>         _emitShader;
+    std::unique_ptr<Shader>         _simulateShader;
+    std::unique_ptr<Shader>         _finalizeShader;
+    std::unique_ptr<GpuBuffer>      _positions;
+    std::unique_ptr<GpuBuffer>      _lifetimes;
+    std::unique_ptr<GpuBuffer>      _alive[2];
+    std::unique_ptr<GpuBuffer>      _dead;
+    std::unique_ptr<GpuBuffer>      _counters;
+    std::unique_ptr<VertexArray>    _emptyVao;
+};
+
+#endif // _particlesystem_h_
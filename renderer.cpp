@@ -1,41 +1,33 @@
 #include "renderer.h"
-#include <iostream>
+#include "glcapture.h"
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void GLClearError()
+void Renderer::Clear(GLDebug::Caller caller) const
 {
-    while ( glGetError() != GL_NO_ERROR )
-    {
-    }
+    GLCallFrom(caller, glClear(GL_COLOR_BUFFER_BIT));
+    GLCapture::Clear(GL_COLOR_BUFFER_BIT);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-bool GLLogCall(const char* function, const char* file, int line)
+void Renderer::Draw(const VertexArray& va, const IndexBuffer &ib, const Shader &shader, GLDebug::Caller caller) const
 {
-    while(GLenum error = glGetError())
-    {
-        std::cout << "[OpenGL Error] (" << error << "):" << function << " " << file << ": " << line << "\n";
-        return false;
-    }
-
-    return true;
-}
-
-// -----------------------------------------------------------------------------
-// -----------------------------------------------------------------------------
-void Renderer::Clear() const
-{
-    glClear(GL_COLOR_BUFFER_BIT);
+    va.Bind(caller);
+    ib.Bind(caller);
+    shader.Bind(caller);
+    GLCallFrom(caller, glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+    GLCapture::DrawElements(GL_TRIANGLES, ib.GetCount());
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void Renderer::Draw(const VertexArray& va, const IndexBuffer &ib, const Shader &shader) const
+void Renderer::Draw(const VertexArray& va, const IndexBuffer &ib, const Shader &shader, unsigned int indexCount,
+                    GLDebug::Caller caller) const
 {
-    va.Bind();
-    ib.Bind();
-    shader.Bind();
-    glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr);
+    va.Bind(caller);
+    ib.Bind(caller);
+    shader.Bind(caller);
+    GLCallFrom(caller, glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr));
+    GLCapture::DrawElements(GL_TRIANGLES, indexCount);
 }
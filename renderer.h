@@ -7,16 +7,7 @@
 #include "vertexarray.h"
 #include "indexbuffer.h"
 #include "shader.h"
-
-#ifdef WIN
-    #define ASSERT(x) if (!(x)) __debugBreak();
-    #define GLCall(x) GLClearError();\
-        x;\
-        ASSERT(GLLogCall(#x, __FILE__, __LINE__))
-#endif
-
-void GLClearError();
-bool GLLogCall(const char* function, const char* file, int line);
+#include "gldebug.h"
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
@@ -24,8 +15,11 @@ class Renderer
 {
 public:
 
-    void Clear() const;
-    void Draw(const VertexArray& va, const IndexBuffer &ib, const Shader &shader) const;
+    void Clear(GLDebug::Caller caller = {}) const;
+    void Draw(const VertexArray& va, const IndexBuffer &ib, const Shader &shader, GLDebug::Caller caller = {}) const;
+    // draws only the first indexCount indices of ib
+    void Draw(const VertexArray& va, const IndexBuffer &ib, const Shader &shader, unsigned int indexCount,
+              GLDebug::Caller caller = {}) const;
 };
 
 #endif // _renderer_h_
@@ -0,0 +1,250 @@
+#include "renderer.h"
+#include "renderqueue.h"
+#include "framebuffer.h"
+#include "texture.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+RenderQueue::RenderQueue()
+{
+    _overdrawShader = std::make_unique<Shader>("res/shaders/overdraw.shader");
+    _heatMapShader = std::make_unique<Shader>("res/shaders/overdraw_heatmap.shader");
+    _emptyVao = std::make_unique<VertexArray>();
+    GLCall(glGenQueries(s_queryCount, _queries));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+RenderQueue::~RenderQueue()
+{
+    GLCall(glDeleteQueries(s_queryCount, _queries));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderQueue::Submit(const VertexArray& va, const IndexBuffer& ib, const Material& material, const glm::mat4& model)
+{
+    _items.push_back({ &va, &ib, &material, model, 0.0f, (unsigned int)_items.size() });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderQueue::ReadQueries()
+{
+    unsigned int index = _frame % s_queryCount;
+    if ( !_queryIssued[index] )
+        return;
+
+    GLuint64 samples = 0;
+    GLCall(glGetQueryObjectui64v(_queries[index], GL_QUERY_RESULT, &samples));
+    _stats.samplesPassed = samples;
+    _queryIssued[index] = false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderQueue::Flush(const glm::mat4& viewProj)
+{
+    GLint viewport[4];
+    GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+
+    ReadQueries();
+
+    // the pass lists come from the frame arena and _items keeps its capacity,
+    // so once warm a flush makes no heap allocation
+    FrameVector<const DrawItem*> opaque;
+    FrameVector<const DrawItem*> translucent;
+    opaque.reserve(_items.size());
+    translucent.reserve(_items.size());
+
+    for ( DrawItem& item : _items )
+    {
+        glm::vec4 clip = viewProj * item.model[3];
+        item.depth = clip.z / clip.w;
+
+        if ( _mode == Mode::SplitPasses && item.material->GetBlendMode() != BlendMode::Translucent )
+            opaque.push_back(&item);
+        else
+            translucent.push_back(&item);
+    }
+
+    if ( _mode == Mode::SplitPasses )
+    {
+        // the submission index keeps equal depths in order, which stable_sort
+        // would do with a temporary buffer allocated on every flush
+        std::sort(opaque.begin(), opaque.end(), [](const DrawItem* a, const DrawItem* b)
+                  { return a->depth != b->depth ? a->depth < b->depth : a->order < b->order; });
+        std::sort(translucent.begin(), translucent.end(), [](const DrawItem* a, const DrawItem* b)
+                  { return a->depth != b->depth ? a->depth > b->depth : a->order < b->order; });
+    }
+
+    ArrayView<const DrawItem*> opaqueItems(opaque.data(), opaque.size());
+    ArrayView<const DrawItem*> translucentItems(translucent.data(), translucent.size());
+
+    if ( _overdrawView )
+    {
+        if ( !_overdrawTarget )
+            _overdrawTarget = std::make_unique<Framebuffer>(viewport[2], viewport[3], true);
+        _overdrawTarget->Resize(viewport[2], viewport[3]);
+        _overdrawTarget->Bind();
+        GLCall(glClearColor( 0.0f, 0.0f, 0.0f, 0.0f ));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    }
+    else
+    {
+        GLCall(glClear(GL_DEPTH_BUFFER_BIT));
+    }
+
+    Pass colorPass = _overdrawView ? Pass::Overdraw : Pass::Color;
+    if ( _overdrawView )
+        GLCall(glBlendFunc(GL_ONE, GL_ONE));
+    else
+        GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+    if ( _mode == Mode::SplitPasses )
+    {
+        // LEQUAL keeps submission order for draws at equal depth
+        GLCall(glEnable(GL_DEPTH_TEST));
+        GLCall(glDepthFunc(GL_LEQUAL));
+
+        if ( _depthPrePass )
+        {
+            GLCall(glDisable(GL_BLEND));
+            GLCall(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+            DrawItems(opaqueItems, viewProj, Pass::DepthOnly);
+            GLCall(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+        }
+
+        GLCall(glBeginQuery(GL_SAMPLES_PASSED, _queries[_frame % s_queryCount]));
+
+        // after a pre-pass only the nearest fragment of each pixel passes
+        GLCall(glDepthMask(_depthPrePass ? GL_FALSE : GL_TRUE));
+        if ( _overdrawView )
+            GLCall(glEnable(GL_BLEND));
+        else
+            GLCall(glDisable(GL_BLEND));
+        DrawItems(opaqueItems, viewProj, colorPass);
+
+        GLCall(glDepthMask(GL_FALSE));
+        GLCall(glEnable(GL_BLEND));
+        DrawItems(translucentItems, viewProj, colorPass);
+
+        GLCall(glEndQuery(GL_SAMPLES_PASSED));
+    }
+    else
+    {
+        GLCall(glDisable(GL_DEPTH_TEST));
+        GLCall(glEnable(GL_BLEND));
+
+        GLCall(glBeginQuery(GL_SAMPLES_PASSED, _queries[_frame % s_queryCount]));
+        DrawItems(translucentItems, viewProj, colorPass);
+        GLCall(glEndQuery(GL_SAMPLES_PASSED));
+    }
+
+    _queryIssued[_frame % s_queryCount] = true;
+    ++_frame;
+
+    // back to the state everything else expects
+    GLCall(glDisable(GL_DEPTH_TEST));
+    GLCall(glDepthMask(GL_TRUE));
+    GLCall(glDepthFunc(GL_LESS));
+    GLCall(glEnable(GL_BLEND));
+    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+    if ( _overdrawView )
+    {
+        _overdrawTarget->Unbind();
+        GLCall(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+        ResolveOverdraw();
+    }
+
+    _stats.opaqueDraws = (unsigned int)opaque.size();
+    _stats.translucentDraws = (unsigned int)translucent.size();
+    _stats.pixels = (uint64_t)viewport[2] * (uint64_t)viewport[3];
+    _items.clear();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderQueue::DrawItems(ArrayView<const DrawItem*> items, const glm::mat4& viewProj, Pass pass)
+{
+    Renderer renderer;
+    const Material* bound = nullptr;
+
+    for ( const DrawItem* item : items )
+    {
+        Shader& shader = pass == Pass::Color ? item->material->GetShader() : *_overdrawShader;
+
+        if ( item->material != bound )
+        {
+            if ( pass == Pass::Color )
+            {
+                item->material->Bind();
+            }
+            else
+            {
+                // every shaded fragment adds one to the red channel
+                shader.Bind();
+                item->material->GetTexture().Bind(0);
+                shader.SetUniform1i("u_Texture", 0);
+                shader.SetUniform1f("u_AlphaCutoff", item->material->GetAlphaCutoff());
+                shader.SetUniform1f("u_Increment", 1.0f / 255.0f);
+            }
+            bound = item->material;
+        }
+
+        shader.SetUniformMat4f("u_MVP", viewProj * item->model);
+        renderer.Draw(*item->va, *item->ib, shader);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderQueue::ResolveOverdraw()
+{
+    GLCall(glDisable(GL_BLEND));
+
+    _heatMapShader->Bind();
+    _overdrawTarget->BindTexture(0);
+    _heatMapShader->SetUniform1i("u_Overdraw", 0);
+    _heatMapShader->SetUniform1f("u_MaxLayers", (float)_overdrawMax);
+
+    _emptyVao->Bind();
+    GLCall(glDrawArrays(GL_TRIANGLES, 0, 3));
+
+    GLCall(glEnable(GL_BLEND));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderQueue::OnImGuiRender()
+{
+    static const char* modes[] = { "Blend everything", "Opaque / translucent split" };
+
+    int mode = (int)_mode;
+    if ( ImGui::Combo("Passes", &mode, modes, 2) )
+        _mode = (Mode)mode;
+
+    if ( _mode == Mode::SplitPasses )
+        ImGui::Checkbox("Depth pre-pass", &_depthPrePass);
+
+    ImGui::Checkbox("Overdraw heat map", &_overdrawView);
+    if ( _overdrawView )
+        ImGui::SliderInt("Layers at full heat", &_overdrawMax, 2, 64);
+
+    ImGui::Text("Draws: %u opaque, %u translucent", _stats.opaqueDraws, _stats.translucentDraws);
+
+    // sampled so the overlay is not redrawn every frame
+    if ( ImGui::GetTime() - _lastSampleTime >= 0.5 )
+    {
+        _shownSamples = _stats.samplesPassed;
+        _lastSampleTime = ImGui::GetTime();
+    }
+
+    double perPixel = _stats.pixels ? (double)_shownSamples / (double)_stats.pixels : 0.0;
+    ImGui::Text("Samples passed: %llu (%.2f per pixel)", (unsigned long long)_shownSamples, perPixel);
+}
@@ -0,0 +1,129 @@
+#ifndef _renderqueue_h_
+#define _renderqueue_h_
+
+#include "material.h"
+#include "allocators.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class VertexArray;
+class IndexBuffer;
+class Shader;
+class Framebuffer;
+
+// -----------------------------------------------------------------------------
+// Collects draws for a frame and splits them by material blend mode. Opaque
+// and masked draws go front to back with depth writes and no blending so
+// early-Z rejects what is hidden; only translucent draws are blended, back to
+// front, on top. BlendAll keeps the old behaviour of blending everything in
+// submission order for comparison.
+//
+// The overdraw view counts shaded fragments into an offscreen target and
+// shows them as a heat map; GL_SAMPLES_PASSED counts the same fragments in
+// the normal view.
+// -----------------------------------------------------------------------------
+class RenderQueue
+{
+public:
+
+    enum class Mode
+    {
+        BlendAll,
+        SplitPasses
+    };
+
+    struct Stats
+    {
+        unsigned int    opaqueDraws         = 0;
+        unsigned int    translucentDraws    = 0;
+        uint64_t        samplesPassed       = 0;    // a few frames old
+        uint64_t        pixels              = 0;
+    };
+
+    RenderQueue();
+    ~RenderQueue();
+
+    // the material and buffers must stay alive until the next Flush
+    void Submit(const VertexArray& va, const IndexBuffer& ib, const Material& material, const glm::mat4& model);
+
+    // draws and clears the queue; clears the depth buffer of the bound
+    // framebuffer first, which must have one
+    void Flush(const glm::mat4& viewProj);
+
+    void OnImGuiRender();
+
+    inline void SetMode(Mode mode)
+    {
+        _mode = mode;
+    }
+
+    inline Mode GetMode() const
+    {
+        return _mode;
+    }
+
+    inline void SetDepthPrePass(bool enabled)
+    {
+        _depthPrePass = enabled;
+    }
+
+    inline void SetOverdrawView(bool enabled)
+    {
+        _overdrawView = enabled;
+    }
+
+    inline const Stats& GetStats() const
+    {
+        return _stats;
+    }
+
+private:
+
+    struct DrawItem
+    {
+        const VertexArray*  va;
+        const IndexBuffer*  ib;
+        const Material*     material;
+        glm::mat4           model;
+        float               depth;      // clip space z / w, smaller is closer
+        unsigned int        order;      // submission index, breaks depth ties
+    };
+
+    enum class Pass
+    {
+        Color,
+        DepthOnly,
+        Overdraw
+    };
+
+    void DrawItems(ArrayView<const DrawItem*> items, const glm::mat4& viewProj, Pass pass);
+    void ResolveOverdraw();
+    void ReadQueries();
+
+    std::vector<DrawItem>               _items;
+
+    Mode                                _mode           = Mode::SplitPasses;
+    bool                                _depthPrePass   = false;
+    bool                                _overdrawView   = false;
+    int                                 _overdrawMax    = 8;
+
+    std::unique_ptr<Shader>             _overdrawShader;    // also used for the depth pre-pass
+    std::unique_ptr<Shader>             _heatMapShader;
+    std::unique_ptr<Framebuffer>        _overdrawTarget;
+    std::unique_ptr<VertexArray>        _emptyVao;
+
+    static constexpr unsigned int       s_queryCount    = 4;
+    unsigned int                        _queries[s_queryCount]      = {};
+    bool                                _queryIssued[s_queryCount]  = {};
+    unsigned int                        _frame          = 0;
+
+    Stats                               _stats;
+    uint64_t                            _shownSamples   = 0;
+    double                              _lastSampleTime = 0.0;
+};
+
+#endif // _renderqueue_h_
@@ -0,0 +1,280 @@
+#include "renderer.h"
+#include "renderscaler.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+
+// results within this fraction of the budget leave the scale alone
+const float s_deadband  = 0.05f;
+
+// fraction of the way to the estimated scale taken per frame, going down
+// quickly so frames are not missed for long and up slowly so it settles
+const float s_downGain  = 0.5f;
+const float s_upGain    = 0.1f;
+
+// the scene size moves in steps of this many pixels
+const int   s_granularity = 8;
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+RenderScaler::RenderScaler()
+{
+    _emptyVao = std::make_unique<VertexArray>();
+
+    _upscaleShader = std::make_unique<Shader>("res/shaders/upscale.shader");
+    _upscaleShader->Bind();
+    _upscaleShader->SetUniform1i("u_Scene", 0);
+
+    _sharpenShader = std::make_unique<Shader>("res/shaders/sharpen.shader");
+    _sharpenShader->Bind();
+    _sharpenShader->SetUniform1i("u_Image", 0);
+
+    for ( unsigned int ii = 0; ii < s_queryCount; ++ii )
+        glGenQueries(3, _queries[ii]);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+RenderScaler::~RenderScaler()
+{
+    for ( unsigned int ii = 0; ii < s_queryCount; ++ii )
+        glDeleteQueries(3, _queries[ii]);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderScaler::BeginScene(int width, int height)
+{
+    ReadQueries();
+
+    _width = width;
+    _height = height;
+    _sceneWidth = width;
+    _sceneHeight = height;
+
+    if ( _enabled && _scale < 1.0f && width > 0 && height > 0 )
+    {
+        _sceneWidth = std::min(width, std::max(s_granularity, (int)(width * _scale) / s_granularity * s_granularity));
+        _sceneHeight = std::min(height, std::max(s_granularity, (int)(height * _scale) / s_granularity * s_granularity));
+    }
+
+    // at native size the scene goes straight to the default framebuffer, so
+    // there is no extra pass and no sharpening of an image that was not scaled
+    _offscreen = _sceneWidth != width || _sceneHeight != height;
+    if ( _offscreen )
+    {
+        // allocated at the window size, only the viewport follows the scale
+        if ( !_scene )
+            _scene = std::make_unique<Framebuffer>(width, height, true);
+        else
+            _scene->Resize(width, height);
+
+        _scene->Bind();
+        glViewport(0, 0, _sceneWidth, _sceneHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    glQueryCounter(_queries[_frame % s_queryCount][0], GL_TIMESTAMP);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderScaler::EndScene()
+{
+    unsigned int index = _frame % s_queryCount;
+    glQueryCounter(_queries[index][1], GL_TIMESTAMP);
+
+    if ( _offscreen )
+        Resolve();
+
+    glQueryCounter(_queries[index][2], GL_TIMESTAMP);
+
+    Sample& sample = _querySample[index];
+    sample.frame = _frame;
+    sample.scale = _offscreen ? (float)_sceneWidth / (float)_width : 1.0f;
+    sample.width = _sceneWidth;
+    sample.height = _sceneHeight;
+    sample.targetMs = _targetMs;
+    _queryIssued[index] = true;
+    ++_frame;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderScaler::Resolve()
+{
+    _scene->Unbind();
+    glDisable(GL_BLEND);
+
+    _emptyVao->Bind();
+    _scene->BindTexture(0);
+    _upscaleShader->Bind();
+    _upscaleShader->SetUniform2f("u_InputSize", (float)_sceneWidth, (float)_sceneHeight);
+    _upscaleShader->SetUniform2f("u_TextureSize", (float)_width, (float)_height);
+
+    if ( _upscale == Upscale::Bilinear )
+    {
+        _upscaleShader->SetUniform1i("u_EdgeAware", 0);
+        glViewport(0, 0, _width, _height);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    else
+    {
+        if ( !_upscaled )
+            _upscaled = std::make_unique<Framebuffer>(_width, _height);
+        else
+            _upscaled->Resize(_width, _height);
+
+        _upscaleShader->SetUniform1i("u_EdgeAware", 1);
+        _upscaled->Bind();
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        _upscaled->Unbind();
+
+        glViewport(0, 0, _width, _height);
+        _upscaled->BindTexture(0);
+        _sharpenShader->Bind();
+        _sharpenShader->SetUniform1f("u_Sharpness", _sharpness);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    glEnable(GL_BLEND);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderScaler::ReadQueries()
+{
+    // the oldest slot is the one about to be reused
+    unsigned int index = _frame % s_queryCount;
+    if ( !_queryIssued[index] )
+        return;
+
+    _queryIssued[index] = false;
+
+    GLint available = 0;
+    glGetQueryObjectiv(_queries[index][2], GL_QUERY_RESULT_AVAILABLE, &available);
+    if ( !available )
+        return;
+
+    GLuint64 timestamps[3] = {};
+    for ( int ii = 0; ii < 3; ++ii )
+        glGetQueryObjectui64v(_queries[index][ii], GL_QUERY_RESULT, &timestamps[ii]);
+
+    Sample& sample = _querySample[index];
+    sample.sceneMs = (float)((timestamps[1] - timestamps[0]) * 1e-6);
+    sample.upscaleMs = (float)((timestamps[2] - timestamps[1]) * 1e-6);
+
+    _trace[_traceHead] = sample;
+    _traceHead = (_traceHead + 1) % s_history;
+    _traceCount = std::min(_traceCount + 1, s_history);
+
+    if ( _enabled && _automatic )
+        UpdateScale(sample.sceneMs);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderScaler::UpdateScale(float sceneMs)
+{
+    float ratio = _targetMs / std::max(sceneMs, 0.01f);
+    if ( std::fabs(ratio - 1.0f) < s_deadband )
+        return;
+
+    // scene cost is taken as proportional to the pixel count, so the area
+    // that meets the budget is the current one times the ratio
+    float estimate = _scale * std::sqrt(ratio);
+    float gain = estimate < _scale ? s_downGain : s_upGain;
+    _scale = std::min(1.0f, std::max(_minScale, _scale + (estimate - _scale) * gain));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool RenderScaler::WriteTrace(const std::string& path) const
+{
+    std::ofstream csv(path);
+    if ( !csv )
+        return false;
+
+    csv << "frame,scale,width,height,scene_gpu_ms,upscale_gpu_ms,target_ms\n";
+
+    unsigned int first = (_traceHead + s_history - _traceCount) % s_history;
+    for ( unsigned int ii = 0; ii < _traceCount; ++ii )
+    {
+        const Sample& sample = _trace[(first + ii) % s_history];
+        csv << sample.frame << ',' << sample.scale << ',' << sample.width << ',' << sample.height << ','
+            << sample.sceneMs << ',' << sample.upscaleMs << ',' << sample.targetMs << '\n';
+    }
+
+    return (bool)csv;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void RenderScaler::OnImGuiRender()
+{
+    static const char* upscales[] = { "Bilinear", "Edge aware + sharpen" };
+
+    ImGui::Checkbox("Dynamic resolution", &_enabled);
+    if ( _enabled )
+    {
+        int upscale = (int)_upscale;
+        if ( ImGui::Combo("Upscale", &upscale, upscales, (int)Upscale::Count) )
+            _upscale = (Upscale)upscale;
+        if ( _upscale == Upscale::EdgeAware )
+            ImGui::SliderFloat("Sharpness", &_sharpness, 0.0f, 1.0f);
+
+        ImGui::Checkbox("Follow GPU time", &_automatic);
+        if ( _automatic )
+        {
+            ImGui::SliderFloat("Scene budget (ms)", &_targetMs, 2.0f, 33.0f);
+            ImGui::SliderFloat("Minimum scale", &_minScale, 0.25f, 1.0f);
+        }
+        else
+        {
+            ImGui::SliderFloat("Scale", &_scale, 0.25f, 1.0f);
+        }
+    }
+
+    // refresh twice a second so the plots do not force an overlay redraw
+    double now = ImGui::GetTime();
+    if ( now - _lastSample >= 0.5 )
+    {
+        unsigned int count = std::min(_traceCount, s_plotted);
+        unsigned int first = (_traceHead + s_history - count) % s_history;
+        for ( unsigned int ii = 0; ii < s_plotted; ++ii )
+        {
+            unsigned int age = s_plotted - ii;
+            const Sample* sample = age <= count ? &_trace[(first + count - age) % s_history] : nullptr;
+            _plotScale[ii] = sample ? sample->scale : 0.0f;
+            _plotSceneMs[ii] = sample ? sample->sceneMs : 0.0f;
+        }
+
+        if ( _traceCount > 0 )
+            _shown = _trace[(_traceHead + s_history - 1) % s_history];
+        _lastSample = now;
+    }
+
+    ImGui::Text("Scene %dx%d (%.0f%%), GPU %.2f ms, upscale %.2f ms", _shown.width, _shown.height,
+                _shown.scale * 100.0f, _shown.sceneMs, _shown.upscaleMs);
+    ImGui::PlotLines("##scale", _plotScale, s_plotted, 0, "render scale", 0.0f, 1.0f, ImVec2(0.0f, 60.0f));
+    ImGui::PlotLines("##scenems", _plotSceneMs, s_plotted, 0, "scene GPU ms", 0.0f, _targetMs * 2.0f,
+                     ImVec2(0.0f, 60.0f));
+
+    ImGui::InputText("Trace", _tracePath, sizeof(_tracePath));
+    if ( ImGui::Button("Save trace") )
+    {
+        if ( WriteTrace(_tracePath) )
+            std::cout << "[RenderScaler] wrote " << _traceCount << " frames to " << _tracePath << std::endl;
+        else
+            std::cout << "[RenderScaler] cannot write " << _tracePath << std::endl;
+    }
+}
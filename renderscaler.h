@@ -0,0 +1,119 @@
+#ifndef _renderscaler_h_
+#define _renderscaler_h_
+
+#include "framebuffer.h"
+#include "vertexarray.h"
+#include "shader.h"
+
+#include <memory>
+#include <string>
+
+// -----------------------------------------------------------------------------
+// Dynamic resolution for the scene. Between BeginScene and EndScene drawing
+// goes to the lower left corner of a window sized offscreen target, and the
+// size of that corner follows the scene GPU time, measured with timestamp
+// queries, against a budget. EndScene upscales the result into the default
+// framebuffer, either bilinear or with an edge aware upscale followed by a
+// contrast adaptive sharpen in the spirit of FSR1, so whatever is drawn after
+// it, like the ImGui overlay, stays at native resolution. At a scale of 1 the
+// scene is drawn straight into the default framebuffer and nothing is resolved.
+// -----------------------------------------------------------------------------
+class RenderScaler
+{
+public:
+
+    enum class Upscale
+    {
+        Bilinear,
+        EdgeAware,
+        Count
+    };
+
+    RenderScaler();
+    ~RenderScaler();
+
+    // width and height of the window framebuffer
+    void BeginScene(int width, int height);
+    // leaves the default framebuffer bound with a native viewport
+    void EndScene();
+
+    inline void SetEnabled(bool enable)
+    {
+        _enabled = enable;
+    }
+
+    inline bool IsEnabled() const
+    {
+        return _enabled;
+    }
+
+    inline float GetScale() const
+    {
+        return _enabled ? _scale : 1.0f;
+    }
+
+    // one line per measured frame, false if the file could not be written
+    bool WriteTrace(const std::string& path) const;
+
+    void OnImGuiRender();
+
+private:
+
+    struct Sample
+    {
+        unsigned int    frame;
+        float           scale;
+        int             width;
+        int             height;
+        float           sceneMs;
+        float           upscaleMs;
+        float           targetMs;
+    };
+
+    void ReadQueries();
+    void UpdateScale(float sceneMs);
+    void Resolve();
+
+    std::unique_ptr<Framebuffer>    _scene;
+    std::unique_ptr<Framebuffer>    _upscaled;      // edge aware result, input of the sharpen pass
+    std::unique_ptr<VertexArray>    _emptyVao;
+    std::unique_ptr<Shader>         _upscaleShader;
+    std::unique_ptr<Shader>         _sharpenShader;
+
+    bool            _enabled        = true;
+    bool            _automatic      = true;
+    Upscale         _upscale        = Upscale::EdgeAware;
+    float           _sharpness      = 0.5f;
+    float           _targetMs       = 12.0f;
+    float           _minScale       = 0.5f;
+    float           _scale          = 1.0f;
+
+    // size of this frame, the scene covers [0, _sceneWidth) x [0, _sceneHeight)
+    int             _width          = 0;
+    int             _height         = 0;
+    int             _sceneWidth     = 0;
+    int             _sceneHeight    = 0;
+    bool            _offscreen      = false;
+
+    // scene start, scene end and upscale end, read a few frames late
+    static constexpr unsigned int s_queryCount = 4;
+    unsigned int    _queries[s_queryCount][3]   = {};
+    bool            _queryIssued[s_queryCount]  = {};
+    Sample          _querySample[s_queryCount]  = {};
+    unsigned int    _frame                      = 0;
+
+    static constexpr unsigned int s_history = 1024;
+    Sample          _trace[s_history]       = {};
+    unsigned int    _traceHead              = 0;
+    unsigned int    _traceCount             = 0;
+
+    // refreshed twice a second for display
+    static constexpr unsigned int s_plotted = 240;
+    float           _plotScale[s_plotted]   = {};
+    float           _plotSceneMs[s_plotted] = {};
+    Sample          _shown                  = {};
+    double          _lastSample             = 0.0;
+    char            _tracePath[256]         = "renderscale.csv";
+};
+
+#endif // _renderscaler_h_
@@ -0,0 +1,519 @@
+// -----------------------------------------------------------------------------
+// Replays a trace recorded with GLCapture as fast as possible on a hidden
+// window and reports how long each frame took, for bisecting performance
+// regressions without the interactive app.
+//
+//     replay <trace> [--loops N] [--csv file]
+// -----------------------------------------------------------------------------
+#include "renderer.h"
+#include "gltrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Walks the payload of one command. Reading past the payload returns zeros or
+// nullptr and sets overrun, so a corrupt trace cannot read outside the file.
+// -----------------------------------------------------------------------------
+struct Cursor
+{
+    const uint8_t*  data;
+    const uint8_t*  end;
+    bool            overrun = false;
+
+    template <typename T>
+    T Read()
+    {
+        T value{};
+        if ( (size_t)(end - data) < sizeof(T) )
+        {
+            overrun = true;
+            data = end;
+            return value;
+        }
+
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return value;
+    }
+
+    const uint8_t* Skip(size_t size)
+    {
+        if ( (size_t)(end - data) < size )
+        {
+            overrun = true;
+            data = end;
+            return nullptr;
+        }
+
+        const uint8_t* start = data;
+        data += size;
+        return start;
+    }
+
+    std::string ReadString()
+    {
+        uint32_t length = Read<uint32_t>();
+        const uint8_t* chars = Skip(length);
+        return chars ? std::string((const char*)chars, length) : std::string();
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Recreates the recorded objects and executes the command stream, mapping the
+// recorded GL names to the ones created here.
+// -----------------------------------------------------------------------------
+class Replayer
+{
+public:
+
+    ~Replayer()
+    {
+        for ( auto& entry : _buffers )
+            glDeleteBuffers(1, &entry.second);
+        for ( auto& entry : _textures )
+            glDeleteTextures(1, &entry.second);
+        for ( auto& entry : _vertexArrays )
+            glDeleteVertexArrays(1, &entry.second);
+    }
+
+    // runs commands up to and including the next EndFrame, returns the end,
+    // or nullptr when a command does not fit in the trace or in its own size
+    const uint8_t* ExecuteFrame(const uint8_t* data, const uint8_t* end)
+    {
+        while ( (size_t)(end - data) >= sizeof(TraceCommand) )
+        {
+            TraceCommand command;
+            std::memcpy(&command, data, sizeof(command));
+            data += sizeof(command);
+
+            if ( command.size > (size_t)(end - data) )
+                return nullptr;
+            if ( !Execute((TraceOp)command.op, Cursor{ data, data + command.size }) )
+                return nullptr;
+            data += command.size;
+
+            if ( (TraceOp)command.op == TraceOp::EndFrame )
+                return data;
+        }
+
+        // an unfinished last frame, from a recording cut short
+        return end;
+    }
+
+private:
+
+    static GLuint Find(const std::unordered_map<uint32_t, GLuint>& names, uint32_t id)
+    {
+        auto it = names.find(id);
+        return it != names.end() ? it->second : 0;
+    }
+
+    // false when the payload is shorter than the command needs
+    bool Execute(TraceOp op, Cursor in)
+    {
+        switch ( op )
+        {
+            case TraceOp::CreateBuffer:
+            {
+                // later loops respecify the contents of the existing buffer
+                uint32_t id = in.Read<uint32_t>(), usage = in.Read<uint32_t>(), size = in.Read<uint32_t>();
+                const uint8_t* contents = in.Skip(size);
+                if ( !contents )
+                    break;
+
+                GLuint& name = _buffers[id];
+                if ( !name )
+                    glGenBuffers(1, &name);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, name);
+                glBufferData(GL_COPY_WRITE_BUFFER, size, contents, usage);
+                break;
+            }
+
+            case TraceOp::BindBuffer:
+            {
+                uint32_t target = in.Read<uint32_t>(), id = in.Read<uint32_t>();
+                glBindBuffer(target, Find(_buffers, id));
+                break;
+            }
+
+            case TraceOp::BufferData:
+            {
+                uint32_t target = in.Read<uint32_t>(), size = in.Read<uint32_t>(), usage = in.Read<uint32_t>();
+                glBufferData(target, size, nullptr, usage);
+                break;
+            }
+
+            case TraceOp::BufferSubData:
+            {
+                uint32_t target = in.Read<uint32_t>(), offset = in.Read<uint32_t>(), size = in.Read<uint32_t>();
+                const uint8_t* contents = in.Skip(size);
+                if ( contents )
+                    glBufferSubData(target, offset, size, contents);
+                break;
+            }
+
+            case TraceOp::DeleteBuffer:
+            {
+                auto it = _buffers.find(in.Read<uint32_t>());
+                if ( it != _buffers.end() )
+                {
+                    glDeleteBuffers(1, &it->second);
+                    _buffers.erase(it);
+                }
+                break;
+            }
+
+            case TraceOp::CreateTexture:
+            {
+                uint32_t id = in.Read<uint32_t>();
+                int32_t params[6];
+                for ( int32_t& param : params )
+                    param = in.Read<int32_t>();
+                if ( params[0] < 0 || params[1] < 0 )
+                    return false;
+                const uint8_t* pixels = in.Skip((uint64_t)params[0] * (uint64_t)params[1] * 4u);
+                if ( !pixels )
+                    break;
+
+                GLuint& name = _textures[id];
+                if ( !name )
+                    glGenTextures(1, &name);
+                glBindTexture(GL_TEXTURE_2D, name);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params[2]);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params[3]);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params[4]);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params[5]);
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, params[0], params[1], 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+                break;
+            }
+
+            case TraceOp::BindTexture:
+            {
+                uint32_t slot = in.Read<uint32_t>(), id = in.Read<uint32_t>();
+                glActiveTexture(GL_TEXTURE0 + slot);
+                glBindTexture(GL_TEXTURE_2D, Find(_textures, id));
+                break;
+            }
+
+            case TraceOp::DeleteTexture:
+            {
+                auto it = _textures.find(in.Read<uint32_t>());
+                if ( it != _textures.end() )
+                {
+                    glDeleteTextures(1, &it->second);
+                    _textures.erase(it);
+                }
+                break;
+            }
+
+            case TraceOp::CreateProgram:
+            {
+                uint32_t id = in.Read<uint32_t>();
+                std::string name = in.ReadString();
+                std::string source = in.ReadString();
+                if ( !in.overrun && !_programs.count(id) )
+                    _programs[id] = std::make_unique<Shader>(name, source);
+                break;
+            }
+
+            case TraceOp::UseProgram:
+            {
+                auto it = _programs.find(in.Read<uint32_t>());
+                glUseProgram(it != _programs.end() ? it->second->GetRendererID() : 0);
+                break;
+            }
+
+            case TraceOp::DeleteProgram:
+            {
+                uint32_t id = in.Read<uint32_t>();
+                _programs.erase(id);
+                for ( auto it = _locations.begin(); it != _locations.end(); )
+                    it = (it->first >> 32) == id ? _locations.erase(it) : std::next(it);
+                break;
+            }
+
+            case TraceOp::UniformLocation:
+            {
+                uint32_t program = in.Read<uint32_t>();
+                int32_t location = in.Read<int32_t>();
+                std::string name = in.ReadString();
+                auto it = _programs.find(program);
+                _locations[(uint64_t)program << 32 | (uint32_t)location] =
+                    it != _programs.end() ? glGetUniformLocation(it->second->GetRendererID(), name.c_str()) : -1;
+                break;
+            }
+
+            case TraceOp::Uniform:
+            {
+                uint32_t program = in.Read<uint32_t>();
+                int32_t recorded = in.Read<int32_t>();
+                TraceUniform type = (TraceUniform)in.Read<uint8_t>();
+                uint32_t count = in.Read<uint32_t>();
+                const void* values = in.Skip((size_t)count * GetTraceUniformComponents(type) * 4u);
+                if ( !values )
+                    break;
+
+                auto it = _locations.find((uint64_t)program << 32 | (uint32_t)recorded);
+                GLint location = it != _locations.end() ? it->second : -1;
+                switch ( type )
+                {
+                    case TraceUniform::Int:     glUniform1iv(location, count, (const GLint*)values);              break;
+                    case TraceUniform::UInt:    glUniform1uiv(location, count, (const GLuint*)values);            break;
+                    case TraceUniform::Float:   glUniform1fv(location, count, (const GLfloat*)values);            break;
+                    case TraceUniform::Vec2:    glUniform2fv(location, count, (const GLfloat*)values);            break;
+                    case TraceUniform::Vec4:    glUniform4fv(location, count, (const GLfloat*)values);            break;
+                    case TraceUniform::Mat4:    glUniformMatrix4fv(location, count, GL_FALSE, (const GLfloat*)values); break;
+                }
+                break;
+            }
+
+            case TraceOp::CreateVertexArray:
+            {
+                uint32_t id = in.Read<uint32_t>(), count = in.Read<uint32_t>();
+                GLuint& name = _vertexArrays[id];
+                if ( name )
+                    break;
+
+                glGenVertexArrays(1, &name);
+                glBindVertexArray(name);
+                for ( uint32_t ii = 0; ii < count; ++ii )
+                {
+                    TraceVertexAttribute attribute = in.Read<TraceVertexAttribute>();
+                    if ( in.overrun )
+                        break;
+                    glBindBuffer(GL_ARRAY_BUFFER, Find(_buffers, attribute.buffer));
+                    glEnableVertexAttribArray(attribute.index);
+                    if ( attribute.integer )
+                        glVertexAttribIPointer(attribute.index, attribute.count, attribute.type, attribute.stride,
+                                               (const void*)(uintptr_t)attribute.offset);
+                    else
+                        glVertexAttribPointer(attribute.index, attribute.count, attribute.type, attribute.normalized,
+                                              attribute.stride, (const void*)(uintptr_t)attribute.offset);
+                    if ( attribute.divisor )
+                        glVertexAttribDivisor(attribute.index, attribute.divisor);
+                }
+                break;
+            }
+
+            case TraceOp::BindVertexArray:
+                glBindVertexArray(Find(_vertexArrays, in.Read<uint32_t>()));
+                break;
+
+            case TraceOp::DeleteVertexArray:
+            {
+                auto it = _vertexArrays.find(in.Read<uint32_t>());
+                if ( it != _vertexArrays.end() )
+                {
+                    glDeleteVertexArrays(1, &it->second);
+                    _vertexArrays.erase(it);
+                }
+                break;
+            }
+
+            case TraceOp::DrawElements:
+            {
+                uint32_t mode = in.Read<uint32_t>(), count = in.Read<uint32_t>();
+                glDrawElements(mode, count, GL_UNSIGNED_INT, nullptr);
+                break;
+            }
+
+            case TraceOp::Clear:
+            {
+                uint32_t mask = in.Read<uint32_t>();
+                float color[4];
+                for ( float& component : color )
+                    component = in.Read<float>();
+                glClearColor(color[0], color[1], color[2], color[3]);
+                glClear(mask);
+                break;
+            }
+
+            case TraceOp::State:
+            {
+                TraceRenderState state = in.Read<TraceRenderState>();
+                glViewport(state.viewport[0], state.viewport[1], state.viewport[2], state.viewport[3]);
+                state.blend ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+                glBlendFuncSeparate(state.blendSrcRGB, state.blendDstRGB, state.blendSrcAlpha, state.blendDstAlpha);
+                state.depthTest ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+                glDepthFunc(state.depthFunc);
+                glDepthMask(state.depthMask ? GL_TRUE : GL_FALSE);
+                state.cullFace ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        return !in.overrun;
+    }
+
+    std::unordered_map<uint32_t, GLuint>                    _buffers;
+    std::unordered_map<uint32_t, GLuint>                    _textures;
+    std::unordered_map<uint32_t, GLuint>                    _vertexArrays;
+    std::unordered_map<uint32_t, std::unique_ptr<Shader>>   _programs;
+    std::unordered_map<uint64_t, GLint>                     _locations;
+};
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+static double Percentile(std::vector<double> values, double fraction)
+{
+    if ( values.empty() )
+        return 0.0;
+
+    size_t index = std::min(values.size() - 1, (size_t)(fraction * (values.size() - 1) + 0.5));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if ( argc < 2 )
+    {
+        std::cout << "usage: replay <trace> [--loops N] [--csv file]" << std::endl;
+        return 1;
+    }
+
+    std::string tracePath = argv[1], csvPath;
+    int loops = 1;
+    for ( int ii = 2; ii < argc; ++ii )
+    {
+        std::string arg = argv[ii];
+        if ( arg == "--loops" && ii + 1 < argc )
+            loops = std::max(1, std::atoi(argv[++ii]));
+        else if ( arg == "--csv" && ii + 1 < argc )
+            csvPath = argv[++ii];
+    }
+
+    // read up front so disk access is not timed
+    std::ifstream file(tracePath, std::ios::binary);
+    std::vector<uint8_t> trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    TraceHeader header;
+    if ( trace.size() < sizeof(header) )
+    {
+        std::cout << "cannot read " << tracePath << std::endl;
+        return 1;
+    }
+    std::memcpy(&header, trace.data(), sizeof(header));
+    if ( header.magic != TraceHeader::Magic || header.version != TraceHeader::Version )
+    {
+        std::cout << tracePath << " is not a version " << TraceHeader::Version << " GL trace" << std::endl;
+        return 1;
+    }
+
+    if ( !glfwInit() )
+        return 1;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(header.width, header.height, "replay", nullptr, nullptr);
+    if ( !window )
+    {
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    if ( GLEW_OK != glewInit() )
+        return 1;
+    std::cout << glGetString(GL_RENDERER) << ", " << glGetString(GL_VERSION) << std::endl;
+
+    // the default framebuffer of a hidden window may not own its pixels
+    GLuint framebuffer = 0, renderbuffers[2] = {};
+    glGenRenderbuffers(2, renderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, header.width, header.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, header.width, header.height);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+    const uint8_t* begin = trace.data() + sizeof(header);
+    const uint8_t* end = trace.data() + trace.size();
+
+    std::ofstream csv;
+    if ( !csvPath.empty() )
+    {
+        csv.open(csvPath);
+        csv << "loop,frame,submit_ms,total_ms\n";
+    }
+
+    std::vector<double> totals, submits;
+    const uint8_t* malformed = nullptr;
+    {
+        Replayer replayer;
+        for ( int loop = 0; loop < loops && !malformed; ++loop )
+        {
+            unsigned int frame = 0;
+            for ( const uint8_t* data = begin; data < end; ++frame )
+            {
+                auto start = Clock::now();
+                const uint8_t* frameStart = data;
+                data = replayer.ExecuteFrame(data, end);
+                if ( !data )
+                {
+                    malformed = frameStart;
+                    break;
+                }
+                auto submitted = Clock::now();
+                glFinish();
+                auto finished = Clock::now();
+
+                double submitMs = std::chrono::duration<double, std::milli>(submitted - start).count();
+                double totalMs = std::chrono::duration<double, std::milli>(finished - start).count();
+                submits.push_back(submitMs);
+                totals.push_back(totalMs);
+
+                if ( csv )
+                    csv << loop << "," << frame << "," << submitMs << "," << totalMs << "\n";
+            }
+        }
+    }
+
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(2, renderbuffers);
+
+    if ( malformed )
+    {
+        std::cout << tracePath << " has a truncated or corrupt command in the frame at byte "
+                  << (malformed - trace.data()) << std::endl;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return 1;
+    }
+
+    // the first frame of a loop includes uploading every captured object
+    double average = 0.0;
+    for ( double total : totals )
+        average += total;
+    average /= std::max<size_t>(totals.size(), 1);
+
+    std::cout << header.frameCount << " frames x " << loops << " loops, " << header.width << "x" << header.height << "\n"
+              << "  total ms   avg " << average << "  median " << Percentile(totals, 0.5)
+              << "  p95 " << Percentile(totals, 0.95) << "  max " << Percentile(totals, 1.0) << "\n"
+              << "  submit ms  median " << Percentile(submits, 0.5) << std::endl;
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 64) in;
+
+struct ObjectData
+{
+    vec4 positionScale;
+    vec4 color;
+    vec4 bounds;
+    uvec4 mesh;
+};
+
+struct MeshInfo
+{
+    uint indexCount;
+    uint firstIndex;
+    int baseVertex;
+    float radius;
+};
+
+struct DrawCommand
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+layout(std430, binding = 1) readonly buffer Meshes { MeshInfo meshes[]; };
+layout(std430, binding = 2) writeonly buffer Commands { DrawCommand commands[]; };
+
+uniform vec4 u_Planes[6];
+uniform uint u_ObjectCount;
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+    if ( id >= u_ObjectCount )
+        return;
+
+    ObjectData object = objects[id];
+    MeshInfo mesh = meshes[object.mesh.x];
+
+    bool visible = true;
+    for ( int ii = 0; ii < 6; ++ii )
+        visible = visible && dot(u_Planes[ii].xyz, object.bounds.xyz) + u_Planes[ii].w >= -object.bounds.w;
+
+    commands[id] = DrawCommand(mesh.indexCount, visible ? 1u : 0u, mesh.firstIndex, mesh.baseVertex, id);
+};
@@ -0,0 +1,40 @@
+#shader vertex
+#version 400 core
+#extension GL_ARB_shader_storage_buffer_object : require
+#extension GL_ARB_shading_language_420pack : require
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in uint drawID;
+
+struct ObjectData
+{
+    vec4 positionScale;
+    vec4 color;
+    vec4 bounds;
+    uvec4 mesh;
+};
+
+layout(std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+
+out vec4 v_Color;
+
+uniform mat4 u_ViewProj;
+
+void main()
+{
+    ObjectData object = objects[drawID];
+    vec2 world  = object.positionScale.xy + position * object.positionScale.w;
+    gl_Position = u_ViewProj * vec4(world, object.positionScale.z, 1.0);
+    v_Color     = object.color;
+};
+
+#shader fragment
+#version 400 core
+
+layout(location = 0) out vec4 color;
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+};
@@ -0,0 +1,82 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+    gl_Position = u_MVP * position;
+    v_TexCoord  = texCoord;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+// two texels per light: pixel centre and inverse radii, then color
+uniform samplerBuffer u_Lights;
+// (offset, count) per tile into the index list
+uniform usamplerBuffer u_TileRanges;
+uniform usamplerBuffer u_LightIndices;
+
+uniform int u_LightCount;
+uniform int u_TileSize;
+uniform int u_TilesX;
+uniform vec2 u_GridOrigin;
+uniform vec4 u_Ambient;
+uniform float u_HeatMax;
+uniform int u_Mode;             // 0 tiled, 1 every light, 2 lights per tile
+
+vec3 Shade(int light, vec2 position)
+{
+    vec4 shape = texelFetch(u_Lights, light * 2);
+    vec2 d = (position - shape.xy) * shape.zw;
+    float falloff = clamp(1.0 - dot(d, d), 0.0, 1.0);
+    return texelFetch(u_Lights, light * 2 + 1).rgb * (falloff * falloff);
+}
+
+void main()
+{
+    vec4 albedo = texture(u_Texture, v_TexCoord);
+    vec2 position = gl_FragCoord.xy - u_GridOrigin;
+    vec3 light = u_Ambient.rgb;
+
+    if ( u_Mode == 1 )
+    {
+        for ( int ii = 0; ii < u_LightCount; ++ii )
+            light += Shade(ii, position);
+    }
+    else
+    {
+        ivec2 tile = ivec2(position) / u_TileSize;
+        uvec2 range = texelFetch(u_TileRanges, tile.y * u_TilesX + tile.x).xy;
+
+        if ( u_Mode == 2 )
+        {
+            // black, blue, green, yellow, red, then white once saturated
+            float t = clamp(float(range.y) / u_HeatMax, 0.0, 1.0) * 4.0;
+            vec3 heat = mix(vec3(0.0, 0.0, 0.0), vec3(0.0, 0.0, 1.0), clamp(t, 0.0, 1.0));
+            heat = mix(heat, vec3(0.0, 1.0, 0.0), clamp(t - 1.0, 0.0, 1.0));
+            heat = mix(heat, vec3(1.0, 1.0, 0.0), clamp(t - 2.0, 0.0, 1.0));
+            heat = mix(heat, vec3(1.0, 0.0, 0.0), clamp(t - 3.0, 0.0, 1.0));
+            if ( float(range.y) > u_HeatMax )
+                heat = vec3(1.0);
+            color = vec4(mix(albedo.rgb * 0.25, heat, 0.75), 1.0);
+            return;
+        }
+
+        for ( uint ii = 0u; ii < range.y; ++ii )
+            light += Shade(int(texelFetch(u_LightIndices, int(range.x + ii)).x), position);
+    }
+
+    color = vec4(albedo.rgb * light, albedo.a);
+};
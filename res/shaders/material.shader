@@ -0,0 +1,36 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+// must match overdraw.shader for the depth pre-pass to compare equal
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = u_MVP * position;
+    v_TexCoord  = texCoord;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+uniform vec4 u_Tint;
+uniform float u_AlphaCutoff;    // negative for no alpha test
+
+void main()
+{
+    vec4 texColor = texture(u_Texture, v_TexCoord) * u_Tint;
+    if ( texColor.a < u_AlphaCutoff )
+        discard;
+    color = texColor;
+};
@@ -0,0 +1,36 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = u_MVP * position;
+    v_TexCoord  = texCoord;
+};
+
+#shader fragment
+#version 330 core
+
+// counts shaded fragments with additive blending, and writes depth only
+// when color writes are masked off for the pre-pass
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+uniform float u_AlphaCutoff;
+uniform float u_Increment;
+
+void main()
+{
+    if ( u_AlphaCutoff >= 0.0 && texture(u_Texture, v_TexCoord).a < u_AlphaCutoff )
+        discard;
+    color = vec4(u_Increment, 0.0, 0.0, 0.0);
+};
@@ -0,0 +1,37 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+// full screen triangle from the vertex id, no buffers
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+    v_TexCoord  = corner;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Overdraw;
+uniform float u_MaxLayers;
+
+void main()
+{
+    ivec2 texel = ivec2(v_TexCoord * vec2(textureSize(u_Overdraw, 0)));
+    float layers = texelFetch(u_Overdraw, texel, 0).r * 255.0;
+
+    // black, blue, green, yellow, red, then white once saturated
+    float t = clamp(layers / u_MaxLayers, 0.0, 1.0) * 4.0;
+    vec3 heat = mix(vec3(0.0, 0.0, 0.0), vec3(0.0, 0.0, 1.0), clamp(t, 0.0, 1.0));
+    heat = mix(heat, vec3(0.0, 1.0, 0.0), clamp(t - 1.0, 0.0, 1.0));
+    heat = mix(heat, vec3(1.0, 1.0, 0.0), clamp(t - 2.0, 0.0, 1.0));
+    heat = mix(heat, vec3(1.0, 0.0, 0.0), clamp(t - 3.0, 0.0, 1.0));
+    if ( layers > u_MaxLayers )
+        heat = vec3(1.0);
+    color = vec4(heat, 1.0);
+};
@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 posVel;
+layout(location = 2) in vec2 life;
+
+out vec4 v_Color;
+out vec2 v_Corner;
+
+uniform mat4  u_MVP;
+uniform float u_Size;
+
+void main()
+{
+    v_Corner = corner;
+    if ( life.x >= life.y )
+    {
+        // all four corners land on the same point, nothing is rasterized
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        v_Color = vec4(0.0);
+        return;
+    }
+
+    float t = life.x / life.y;
+    v_Color = mix(vec4(1.0, 0.85, 0.4, 1.0), vec4(0.9, 0.15, 0.05, 0.0), t);
+    gl_Position = u_MVP * vec4(posVel.xy + corner * u_Size, 0.0, 1.0);
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec4 v_Color;
+in vec2 v_Corner;
+
+void main()
+{
+    float falloff = max(1.0 - dot(v_Corner, v_Corner), 0.0);
+    color = vec4(v_Color.rgb, v_Color.a * falloff);
+};
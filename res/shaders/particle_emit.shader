@@ -0,0 +1,67 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) buffer Positions { vec4 posVel[]; };
+layout(std430, binding = 1) buffer Lifetimes { vec2 life[]; };
+layout(std430, binding = 3) writeonly buffer AliveOut { uint aliveOut[]; };
+layout(std430, binding = 4) buffer Dead { uint dead[]; };
+layout(std430, binding = 5) buffer Counters
+{
+    int  aliveCount[2];
+    int  deadCount;
+    int  pad;
+    uvec4 dispatchArgs;
+    uvec4 drawArgs;
+};
+
+uniform int   u_In;
+uniform uint  u_EmitCount;
+uniform uint  u_Seed;
+uniform vec2  u_Emitter;
+uniform float u_Spread;
+uniform float u_SpeedMin;
+uniform float u_SpeedMax;
+uniform float u_LifetimeMin;
+uniform float u_LifetimeMax;
+
+uint Hash(uint x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float Random(uint seed)
+{
+    return float(Hash(seed)) * (1.0 / 4294967295.0);
+}
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+    if ( id >= u_EmitCount )
+        return;
+
+    // pop a dead slot, give it back if the pool ran dry
+    int top = atomicAdd(deadCount, -1);
+    if ( top <= 0 )
+    {
+        atomicAdd(deadCount, 1);
+        return;
+    }
+
+    uint index = dead[top - 1];
+    uint seed = Hash(id ^ u_Seed);
+    float angle = 1.5707963 + (Random(seed) - 0.5) * u_Spread;
+    float speed = mix(u_SpeedMin, u_SpeedMax, Random(seed + 1u));
+    vec2 jitter = vec2(Random(seed + 2u), Random(seed + 3u)) * 4.0 - 2.0;
+    posVel[index] = vec4(u_Emitter + jitter, cos(angle) * speed, sin(angle) * speed);
+    life[index] = vec2(0.0, mix(u_LifetimeMin, u_LifetimeMax, Random(seed + 4u)));
+
+    aliveOut[atomicAdd(aliveCount[1 - u_In], 1)] = index;
+};
@@ -0,0 +1,24 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 1) in;
+
+layout(std430, binding = 5) buffer Counters
+{
+    int  aliveCount[2];
+    int  deadCount;
+    int  pad;
+    uvec4 dispatchArgs;
+    uvec4 drawArgs;
+};
+
+uniform int u_In;
+
+void main()
+{
+    // next frame simulates and draws what this frame left alive
+    uint alive = uint(aliveCount[1 - u_In]);
+    dispatchArgs = uvec4((alive + 255u) / 256u, 1u, 1u, 0u);
+    drawArgs = uvec4(4u, alive, 0u, 0u);
+    aliveCount[u_In] = 0;
+};
@@ -0,0 +1,48 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) buffer Positions { vec4 posVel[]; };
+layout(std430, binding = 1) buffer Lifetimes { vec2 life[]; };
+layout(std430, binding = 2) readonly buffer AliveIn { uint aliveIn[]; };
+layout(std430, binding = 3) writeonly buffer AliveOut { uint aliveOut[]; };
+layout(std430, binding = 4) buffer Dead { uint dead[]; };
+layout(std430, binding = 5) buffer Counters
+{
+    int  aliveCount[2];
+    int  deadCount;
+    int  pad;
+    uvec4 dispatchArgs;
+    uvec4 drawArgs;
+};
+
+uniform float u_DeltaTime;
+uniform vec2  u_Gravity;
+uniform float u_Drag;
+uniform int   u_In;
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+    if ( id >= uint(aliveCount[u_In]) )
+        return;
+
+    uint index = aliveIn[id];
+    vec2 l = life[index];
+    l.x += u_DeltaTime;
+    life[index] = l;
+
+    if ( l.x >= l.y )
+    {
+        dead[atomicAdd(deadCount, 1)] = index;
+        return;
+    }
+
+    vec4 pv = posVel[index];
+    vec2 velocity = (pv.zw + u_Gravity * u_DeltaTime) * (1.0 - u_Drag * u_DeltaTime);
+    posVel[index] = vec4(pv.xy + velocity * u_DeltaTime, velocity);
+
+    // survivors are compacted into the other list
+    aliveOut[atomicAdd(aliveCount[1 - u_In], 1)] = index;
+};
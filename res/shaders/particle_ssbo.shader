@@ -0,0 +1,37 @@
+#shader vertex
+#version 430 core
+
+layout(std430, binding = 0) readonly buffer Positions { vec4 posVel[]; };
+layout(std430, binding = 1) readonly buffer Lifetimes { vec2 life[]; };
+layout(std430, binding = 2) readonly buffer Alive     { uint alive[]; };
+
+out vec4 v_Color;
+out vec2 v_Corner;
+
+uniform mat4  u_MVP;
+uniform float u_Size;
+
+void main()
+{
+    // only live particles are instanced, no dead check needed
+    uint index = alive[gl_InstanceID];
+    vec2 corner = vec2(float(gl_VertexID & 1) * 2.0 - 1.0, float(gl_VertexID >> 1) * 2.0 - 1.0);
+
+    float t = life[index].x / life[index].y;
+    v_Corner = corner;
+    v_Color = mix(vec4(1.0, 0.85, 0.4, 1.0), vec4(0.9, 0.15, 0.05, 0.0), t);
+    gl_Position = u_MVP * vec4(posVel[index].xy + corner * u_Size, 0.0, 1.0);
+};
+
+#shader fragment
+#version 430 core
+
+layout(location = 0) out vec4 color;
+in vec4 v_Color;
+in vec2 v_Corner;
+
+void main()
+{
+    float falloff = max(1.0 - dot(v_Corner, v_Corner), 0.0);
+    color = vec4(v_Color.rgb, v_Color.a * falloff);
+};
@@ -0,0 +1,69 @@
+#feedback out_PosVel out_Life
+
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 in_PosVel;
+layout(location = 1) in vec2 in_Life;
+
+out vec4 out_PosVel;
+out vec2 out_Life;
+
+uniform float u_DeltaTime;
+uniform vec2  u_Gravity;
+uniform float u_Drag;
+
+uniform uint  u_Capacity;
+uniform uint  u_EmitStart;
+uniform uint  u_EmitCount;
+uniform uint  u_Seed;
+uniform vec2  u_Emitter;
+uniform float u_Spread;
+uniform float u_SpeedMin;
+uniform float u_SpeedMax;
+uniform float u_LifetimeMin;
+uniform float u_LifetimeMax;
+
+uint Hash(uint x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float Random(uint seed)
+{
+    return float(Hash(seed)) * (1.0 / 4294967295.0);
+}
+
+void main()
+{
+    uint id = uint(gl_VertexID);
+
+    // slots in the emission ring this frame are respawned in place
+    uint offset = (id + u_Capacity - u_EmitStart) % u_Capacity;
+    if ( offset < u_EmitCount )
+    {
+        uint seed = Hash(id ^ u_Seed);
+        float angle = 1.5707963 + (Random(seed) - 0.5) * u_Spread;
+        float speed = mix(u_SpeedMin, u_SpeedMax, Random(seed + 1u));
+        vec2 jitter = vec2(Random(seed + 2u), Random(seed + 3u)) * 4.0 - 2.0;
+        out_PosVel = vec4(u_Emitter + jitter, cos(angle) * speed, sin(angle) * speed);
+        out_Life = vec2(0.0, mix(u_LifetimeMin, u_LifetimeMax, Random(seed + 4u)));
+        return;
+    }
+
+    if ( in_Life.x >= in_Life.y )
+    {
+        out_PosVel = in_PosVel;
+        out_Life = in_Life;
+        return;
+    }
+
+    vec2 velocity = (in_PosVel.zw + u_Gravity * u_DeltaTime) * (1.0 - u_Drag * u_DeltaTime);
+    out_PosVel = vec4(in_PosVel.xy + velocity * u_DeltaTime, velocity);
+    out_Life = vec2(in_Life.x + u_DeltaTime, in_Life.y);
+};
@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+// full screen triangle from the vertex id, no buffers
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Image;
+uniform float u_Sharpness;      // 0 leaves the image as is
+
+// robust contrast adaptive sharpening on the cross neighbourhood, the same
+// image size as the output so the fragment position is the texel
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    ivec2 last = textureSize(u_Image, 0) - 1;
+
+    vec3 e = texelFetch(u_Image, texel, 0).rgb;
+    vec3 b = texelFetch(u_Image, clamp(texel + ivec2( 0,  1), ivec2(0), last), 0).rgb;
+    vec3 d = texelFetch(u_Image, clamp(texel + ivec2(-1,  0), ivec2(0), last), 0).rgb;
+    vec3 f = texelFetch(u_Image, clamp(texel + ivec2( 1,  0), ivec2(0), last), 0).rgb;
+    vec3 h = texelFetch(u_Image, clamp(texel + ivec2( 0, -1), ivec2(0), last), 0).rgb;
+
+    // the most negative lobe that keeps the result inside [0, 1]
+    vec3 lo = min(min(min(b, d), min(f, h)), e);
+    vec3 hi = max(max(max(b, d), max(f, h)), e);
+    vec3 hitMin = lo / (4.0 * hi + 1e-5);
+    vec3 hitMax = (1.0 - hi) / (4.0 * lo - 4.0 - 1e-5);
+    vec3 limit = max(-hitMin, hitMax);
+    float lobe = max(-0.1875, min(max(limit.x, max(limit.y, limit.z)), 0.0)) * u_Sharpness;
+
+    color = vec4((lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0), 1.0);
+};
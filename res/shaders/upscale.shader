@@ -0,0 +1,111 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+// full screen triangle from the vertex id, no buffers
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+    v_TexCoord  = corner;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Scene;
+uniform vec2 u_InputSize;       // rendered corner of the scene target, in texels
+uniform vec2 u_TextureSize;     // whole scene target
+uniform int u_EdgeAware;
+
+vec3 Fetch(ivec2 texel)
+{
+    return texelFetch(u_Scene, clamp(texel, ivec2(0), ivec2(u_InputSize) - 1), 0).rgb;
+}
+
+float Luma(vec3 rgb)
+{
+    return dot(rgb, vec3(0.299, 0.587, 0.114));
+}
+
+// polynomial fit of lanczos2 on the squared distance as used by EASU, lobe
+// goes from 1/2 (soft, no negative side lobe) to about 1/4 (sharp)
+float Lanczos2(float d2, float lobe)
+{
+    d2 = min(d2, 1.0 / lobe);
+    float base = 2.0 / 5.0 * d2 - 1.0;
+    float window = lobe * d2 - 1.0;
+    return (25.0 / 16.0 * base * base - (25.0 / 16.0 - 1.0)) * window * window;
+}
+
+void main()
+{
+    if ( u_EdgeAware == 0 )
+    {
+        // keep the bilinear footprint inside the rendered corner
+        vec2 texel = clamp(v_TexCoord * u_InputSize, vec2(0.5), u_InputSize - 0.5);
+        color = vec4(texture(u_Scene, texel / u_TextureSize).rgb, 1.0);
+        return;
+    }
+
+    vec2 position = v_TexCoord * u_InputSize - 0.5;
+    ivec2 base = ivec2(floor(position));
+    vec2 f = position - vec2(base);
+
+    // 4x4 neighbourhood, index 5 is the texel left below the sample
+    vec3 rgb[16];
+    float luma[16];
+    for ( int y = 0; y < 4; ++y )
+    {
+        for ( int x = 0; x < 4; ++x )
+        {
+            rgb[y * 4 + x] = Fetch(base + ivec2(x - 1, y - 1));
+            luma[y * 4 + x] = Luma(rgb[y * 4 + x]);
+        }
+    }
+
+    // luma gradient of the inner 2x2, bilinearly weighted towards the sample
+    vec2 gradient = vec2(0.0);
+    for ( int y = 1; y < 3; ++y )
+    {
+        for ( int x = 1; x < 3; ++x )
+        {
+            float w = (x == 1 ? 1.0 - f.x : f.x) * (y == 1 ? 1.0 - f.y : f.y);
+            gradient += w * vec2(luma[y * 4 + x + 1] - luma[y * 4 + x - 1],
+                                 luma[(y + 1) * 4 + x] - luma[(y - 1) * 4 + x]);
+        }
+    }
+
+    float strength = length(gradient);
+    vec2 across = strength > 1e-5 ? gradient / strength : vec2(1.0, 0.0);
+    vec2 along = vec2(-across.y, across.x);
+    float edge = clamp(strength * 2.0, 0.0, 1.0);
+    edge *= edge;
+
+    // on edges the kernel stretches along the edge and sharpens across it
+    float stretch = mix(1.0, 0.5, edge);
+    float lobe = mix(0.5, 0.21, edge);
+
+    vec3 sum = vec3(0.0);
+    float weights = 0.0;
+    for ( int y = 0; y < 4; ++y )
+    {
+        for ( int x = 0; x < 4; ++x )
+        {
+            vec2 offset = vec2(x - 1, y - 1) - f;
+            vec2 rotated = vec2(dot(offset, across), dot(offset, along) * stretch);
+            float w = Lanczos2(dot(rotated, rotated), lobe);
+            sum += w * rgb[y * 4 + x];
+            weights += w;
+        }
+    }
+
+    // the negative lobe rings, clamp to the nearest 2x2
+    vec3 lo = min(min(rgb[5], rgb[6]), min(rgb[9], rgb[10]));
+    vec3 hi = max(max(rgb[5], rgb[6]), max(rgb[9], rgb[10]));
+    color = vec4(clamp(sum / weights, lo, hi), 1.0);
+};
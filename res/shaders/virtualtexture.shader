@@ -0,0 +1,59 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+uniform vec2 u_UVOrigin;
+uniform vec2 u_UVExtent;
+
+void main()
+{
+    gl_Position = u_MVP * position;
+    v_TexCoord  = u_UVOrigin + texCoord * u_UVExtent;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Physical;
+uniform sampler2D u_Indirection;
+uniform vec2  u_VirtualSize;
+uniform float u_TileContent;
+uniform float u_TileSize;
+uniform float u_TileBorder;
+uniform float u_CacheSize;
+uniform int   u_MaxMip;
+
+void main()
+{
+    // level 0 texel position and the mip it wants
+    vec2 texel = v_TexCoord * u_VirtualSize;
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = log2(max(max(length(dx), length(dy)), 1e-6));
+    int level = clamp(int(floor(lod)), 0, u_MaxMip);
+
+    // best resident tile for this spot, possibly a coarser one
+    ivec2 tiles = textureSize(u_Indirection, level);
+    ivec2 tile = clamp(ivec2(floor(texel * exp2(-float(level)) / u_TileContent)), ivec2(0), tiles - 1);
+    vec4 entry = texelFetch(u_Indirection, tile, level);
+    if ( entry.a == 0.0 )
+    {
+        color = vec4(1.0, 0.0, 1.0, 1.0);
+        return;
+    }
+
+    float mip = floor(entry.b * 255.0 + 0.5);
+    vec2 slot = floor(entry.rg * 255.0 + 0.5);
+    vec2 inTile = fract(texel * exp2(-mip) / u_TileContent);
+    vec2 physical = (slot * u_TileSize + u_TileBorder + inTile * u_TileContent) / u_CacheSize;
+
+    color = textureLod(u_Physical, physical, 0.0);
+};
@@ -0,0 +1,187 @@
+#include "resourcemanager.h"
+#include "vertexbufferlayout.h"
+
+#include <imgui.h>
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for ( size_t ii = 0; ii < size; ++ii )
+    {
+        hash ^= bytes[ii];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceManager& ResourceManager::Get()
+{
+    static ResourceManager instance;
+    return instance;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+template <typename T, typename... Args>
+ResourceRef<T> ResourceManager::Acquire(uint64_t key, Args&&... args)
+{
+    ResourcePool<T>& pool = std::get<ResourcePool<T>>(_pools);
+
+    Handle<T> handle = pool.Find(key);
+    if ( handle.IsValid() )
+    {
+        ++_hits;
+        return ResourceRef<T>(handle);
+    }
+
+    ++_loads;
+    return ResourceRef<T>(pool.Create(key, std::forward<Args>(args)...));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceRef<Texture> ResourceManager::LoadTexture(const std::string& path)
+{
+    return Acquire<Texture>(HashBytes(path.data(), path.size()), path);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceRef<Shader> ResourceManager::LoadShader(const std::string& path)
+{
+    return Acquire<Shader>(HashBytes(path.data(), path.size()), path);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceRef<Texture> ResourceManager::LoadTexture(const std::string& path, int width, int height,
+                                                  const unsigned char* rgba)
+{
+    return Acquire<Texture>(HashBytes(path.data(), path.size()), path, width, height, rgba);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceRef<Shader> ResourceManager::LoadShader(const std::string& path, const std::string& source)
+{
+    return Acquire<Shader>(HashBytes(path.data(), path.size()), path, source);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool ResourceManager::IsTextureLoaded(const std::string& path)
+{
+    return std::get<ResourcePool<Texture>>(_pools).Contains(HashBytes(path.data(), path.size()));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool ResourceManager::IsShaderLoaded(const std::string& path)
+{
+    return std::get<ResourcePool<Shader>>(_pools).Contains(HashBytes(path.data(), path.size()));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceRef<VertexBuffer> ResourceManager::LoadVertexBuffer(const void* data, unsigned int size)
+{
+    uint64_t key = HashBytes(&size, sizeof(size));
+    key = HashBytes(data, size, key);
+    return Acquire<VertexBuffer>(key, data, size);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceRef<IndexBuffer> ResourceManager::LoadIndexBuffer(const unsigned int* data, unsigned int count)
+{
+    uint64_t key = HashBytes(&count, sizeof(count));
+    key = HashBytes(data, count * sizeof(unsigned int), key);
+    return Acquire<IndexBuffer>(key, data, count);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ResourceRef<VertexArray> ResourceManager::LoadVertexArray(const ResourceRef<VertexBuffer>& vb,
+                                                          const VertexBufferLayout& layout)
+{
+    // the buffer handle carries its generation so a recycled slot never
+    // matches a vertex array built for the previous occupant
+    uint32_t handle = vb.GetHandle().value;
+    uint64_t key = HashBytes(&handle, sizeof(handle));
+    for ( const auto& element : layout.GetElements() )
+    {
+        unsigned int fields[3] = { element.type, element.count, element.normalized };
+        key = HashBytes(fields, sizeof(fields), key);
+    }
+
+    ResourcePool<VertexArray>& pool = std::get<ResourcePool<VertexArray>>(_pools);
+    Handle<VertexArray> found = pool.Find(key);
+    if ( found.IsValid() )
+    {
+        ++_hits;
+        return ResourceRef<VertexArray>(found);
+    }
+
+    ++_loads;
+    Handle<VertexArray> created = pool.Create(key);
+    pool.Get(created)->AddBuffer(*vb, layout);
+    return ResourceRef<VertexArray>(created);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ResourceManager::EndFrame()
+{
+    ++_frame;
+
+    std::apply([this](auto&... pool)
+    {
+        ((_destroyed += pool.Collect(_frame, _releaseDelay)), ...);
+    }, _pools);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ResourceManager::Shutdown()
+{
+    // vertex arrays first, they reference the buffers
+    std::get<ResourcePool<VertexArray>>(_pools).Clear();
+    std::apply([](auto&... pool)
+    {
+        (pool.Clear(), ...);
+    }, _pools);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ResourceManager::OnImGuiRender()
+{
+    ImGui::Text("Loads: %zu  Cache hits: %zu  Destroyed: %zu", _loads, _hits, _destroyed);
+    ImGui::Text("Textures: %zu  Shaders: %zu  Vertex buffers: %zu  Index buffers: %zu  Vertex arrays: %zu",
+                std::get<ResourcePool<Texture>>(_pools).GetLiveCount(),
+                std::get<ResourcePool<Shader>>(_pools).GetLiveCount(),
+                std::get<ResourcePool<VertexBuffer>>(_pools).GetLiveCount(),
+                std::get<ResourcePool<IndexBuffer>>(_pools).GetLiveCount(),
+                std::get<ResourcePool<VertexArray>>(_pools).GetLiveCount());
+
+    size_t pending = 0;
+    std::apply([&pending](auto&... pool)
+    {
+        ((pending += pool.GetPendingCount()), ...);
+    }, _pools);
+    ImGui::Text("Unreferenced, awaiting release: %zu", pending);
+
+    int delay = (int)_releaseDelay;
+    if ( ImGui::SliderInt("Release delay (frames)", &delay, (int)s_framesInFlight, 3600) )
+        SetReleaseDelay((unsigned int)delay);
+}
@@ -0,0 +1,172 @@
+#ifndef _resourcemanager_h_
+#define _resourcemanager_h_
+
+#include "resourcepool.h"
+#include "texture.h"
+#include "shader.h"
+#include "vertexbuffer.h"
+#include "indexbuffer.h"
+#include "vertexarray.h"
+
+#include <string>
+#include <tuple>
+
+class VertexBufferLayout;
+
+template <typename T> class ResourceRef;
+
+// -----------------------------------------------------------------------------
+// Central cache of GL resources. Files are keyed by path and buffers by a hash
+// of their contents so asking for the same resource twice shares one GL
+// object. Resources nobody references anymore are destroyed from EndFrame
+// once they stayed unused for the release delay.
+// -----------------------------------------------------------------------------
+class ResourceManager
+{
+public:
+
+    static ResourceManager& Get();
+
+    ResourceRef<Texture>        LoadTexture(const std::string& path);
+    ResourceRef<Shader>         LoadShader(const std::string& path);
+
+    // cached under path like the loads above, for files read ahead of time
+    ResourceRef<Texture>        LoadTexture(const std::string& path, int width, int height,
+                                            const unsigned char* rgba);
+    ResourceRef<Shader>         LoadShader(const std::string& path, const std::string& source);
+    bool                        IsTextureLoaded(const std::string& path);
+    bool                        IsShaderLoaded(const std::string& path);
+    ResourceRef<VertexBuffer>   LoadVertexBuffer(const void* data, unsigned int size);
+    ResourceRef<IndexBuffer>    LoadIndexBuffer(const unsigned int* data, unsigned int count);
+    ResourceRef<VertexArray>    LoadVertexArray(const ResourceRef<VertexBuffer>& vb,
+                                                const VertexBufferLayout& layout);
+
+    template <typename T>
+    inline T* Get(Handle<T> handle)
+    {
+        return std::get<ResourcePool<T>>(_pools).Get(handle);
+    }
+
+    template <typename T>
+    inline void AddRef(Handle<T> handle)
+    {
+        std::get<ResourcePool<T>>(_pools).AddRef(handle);
+    }
+
+    template <typename T>
+    inline void Release(Handle<T> handle)
+    {
+        std::get<ResourcePool<T>>(_pools).Release(handle, _frame);
+    }
+
+    void EndFrame();
+    void Shutdown();
+
+    inline void SetReleaseDelay(unsigned int frames)
+    {
+        _releaseDelay = frames < s_framesInFlight ? s_framesInFlight : frames;
+    }
+
+    void OnImGuiRender();
+
+    static constexpr unsigned int s_framesInFlight = 3;
+
+private:
+
+    ResourceManager() = default;
+
+    template <typename T, typename... Args>
+    ResourceRef<T> Acquire(uint64_t key, Args&&... args);
+
+    std::tuple<ResourcePool<Texture>,
+               ResourcePool<Shader>,
+               ResourcePool<VertexBuffer>,
+               ResourcePool<IndexBuffer>,
+               ResourcePool<VertexArray>>   _pools;
+
+    unsigned int    _frame          = 0;
+    unsigned int    _releaseDelay   = 600;
+    size_t          _loads          = 0;
+    size_t          _hits           = 0;
+    size_t          _destroyed      = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Shared ownership of a pooled resource, only the 32 bit handle is stored.
+// -----------------------------------------------------------------------------
+template <typename T>
+class ResourceRef
+{
+public:
+
+    ResourceRef() = default;
+
+    // adopts a handle whose reference was already taken
+    explicit ResourceRef(Handle<T> handle)
+        : _handle(handle)
+    {
+    }
+
+    ResourceRef(const ResourceRef& other)
+        : _handle(other._handle)
+    {
+        ResourceManager::Get().AddRef(_handle);
+    }
+
+    ResourceRef(ResourceRef&& other)
+        : _handle(other._handle)
+    {
+        other._handle = Handle<T>();
+    }
+
+    ~ResourceRef()
+    {
+        Reset();
+    }
+
+    ResourceRef& operator=(ResourceRef other)
+    {
+        std::swap(_handle, other._handle);
+        return *this;
+    }
+
+    void Reset()
+    {
+        if ( _handle.IsValid() )
+            ResourceManager::Get().Release(_handle);
+        _handle = Handle<T>();
+    }
+
+    inline Handle<T> GetHandle() const
+    {
+        return _handle;
+    }
+
+    inline T* Get() const
+    {
+        return ResourceManager::Get().Get(_handle);
+    }
+
+    inline T& operator*() const
+    {
+        return *Get();
+    }
+
+    inline T* operator->() const
+    {
+        return Get();
+    }
+
+    inline explicit operator bool() const
+    {
+        return Get() != nullptr;
+    }
+
+private:
+
+    Handle<T>   _handle;
+};
+
+static_assert(sizeof(ResourceRef<Texture>) == sizeof(uint32_t), "resource refs must stay 32 bit");
+
+#endif // _resourcemanager_h_
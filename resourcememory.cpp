@@ -0,0 +1,121 @@
+#include "resourcememory.h"
+#include "textureresidency.h"
+
+#include <atomic>
+#include <imgui.h>
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+struct CategoryStats
+{
+    std::atomic<size_t> bytes{0};
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> peakBytes{0};
+};
+
+CategoryStats s_stats[(int)ResourceMemory::Category::Count];
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ResourceMemory::Allocate(Category category, size_t bytes)
+{
+    CategoryStats& stats = s_stats[(int)category];
+    size_t current = stats.bytes.fetch_add(bytes) + bytes;
+    stats.allocations.fetch_add(1);
+
+    size_t peak = stats.peakBytes.load();
+    while ( current > peak && !stats.peakBytes.compare_exchange_weak(peak, current) )
+    {
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ResourceMemory::Free(Category category, size_t bytes)
+{
+    CategoryStats& stats = s_stats[(int)category];
+    stats.bytes.fetch_sub(bytes);
+    stats.allocations.fetch_sub(1);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t ResourceMemory::GetBytes(Category category)
+{
+    return s_stats[(int)category].bytes.load();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t ResourceMemory::GetAllocations(Category category)
+{
+    return s_stats[(int)category].allocations.load();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t ResourceMemory::GetPeakBytes(Category category)
+{
+    return s_stats[(int)category].peakBytes.load();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t ResourceMemory::GetTotalBytes()
+{
+    size_t total = 0;
+    for ( int ii = 0; ii < (int)Category::Count; ++ii )
+        total += s_stats[ii].bytes.load();
+
+    return total;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const char* ResourceMemory::GetCategoryName(Category category)
+{
+    switch (category)
+    {
+        case Category::Texture:         return "Texture";
+        case Category::VertexBuffer:    return "Vertex Buffer";
+        case Category::IndexBuffer:     return "Index Buffer";
+        case Category::StorageBuffer:   return "Storage Buffer";
+        default:                        break;
+    }
+
+    return "Unknown";
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ResourceMemory::OnImGuiRender()
+{
+    const float mb = 1.0f / (1024.0f * 1024.0f);
+
+    ImGui::Columns(4, "resourcememory");
+    ImGui::Text("Category");    ImGui::NextColumn();
+    ImGui::Text("Objects");     ImGui::NextColumn();
+    ImGui::Text("Size (MB)");   ImGui::NextColumn();
+    ImGui::Text("Peak (MB)");   ImGui::NextColumn();
+    ImGui::Separator();
+
+    for ( int ii = 0; ii < (int)Category::Count; ++ii )
+    {
+        Category category = (Category)ii;
+        ImGui::Text("%s", GetCategoryName(category));               ImGui::NextColumn();
+        ImGui::Text("%zu", GetAllocations(category));               ImGui::NextColumn();
+        ImGui::Text("%.2f", GetBytes(category) * mb);               ImGui::NextColumn();
+        ImGui::Text("%.2f", GetPeakBytes(category) * mb);           ImGui::NextColumn();
+    }
+
+    ImGui::Columns(1);
+    ImGui::Separator();
+    ImGui::Text("Total: %.2f MB", GetTotalBytes() * mb);
+
+    TextureResidency::Get().OnImGuiRender();
+}
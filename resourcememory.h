@@ -0,0 +1,37 @@
+#ifndef _resourcememory_h_
+#define _resourcememory_h_
+
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Book keeping of the GPU memory held by the GL objects we allocate. Every
+// class that creates a buffer or texture reports the size of its storage here
+// so the totals can be displayed and budgets enforced.
+// -----------------------------------------------------------------------------
+class ResourceMemory
+{
+public:
+
+    enum class Category
+    {
+        Texture = 0,
+        VertexBuffer,
+        IndexBuffer,
+        StorageBuffer,
+        Count
+    };
+
+    static void Allocate(Category category, size_t bytes);
+    static void Free(Category category, size_t bytes);
+
+    static size_t GetBytes(Category category);
+    static size_t GetAllocations(Category category);
+    static size_t GetPeakBytes(Category category);
+    static size_t GetTotalBytes();
+
+    static const char* GetCategoryName(Category category);
+
+    static void OnImGuiRender();
+};
+
+#endif // _resourcememory_h_
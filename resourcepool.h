@@ -0,0 +1,228 @@
+#ifndef _resourcepool_h_
+#define _resourcepool_h_
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// 32 bit handle: low 20 bits index into the pool, high 12 bits the generation
+// of the slot. A value of 0 is never handed out and means "no resource".
+// -----------------------------------------------------------------------------
+template <typename T>
+struct Handle
+{
+    static constexpr uint32_t IndexBits      = 20;
+    static constexpr uint32_t IndexMask      = (1u << IndexBits) - 1u;
+    static constexpr uint32_t GenerationMask = (1u << (32 - IndexBits)) - 1u;
+
+    uint32_t value = 0;
+
+    Handle() = default;
+    Handle(uint32_t index, uint32_t generation)
+        : value((generation << IndexBits) | index)
+    {
+    }
+
+    inline uint32_t GetIndex() const
+    {
+        return value & IndexMask;
+    }
+
+    inline uint32_t GetGeneration() const
+    {
+        return value >> IndexBits;
+    }
+
+    inline bool IsValid() const
+    {
+        return value != 0;
+    }
+
+    inline bool operator==(const Handle& other) const
+    {
+        return value == other.value;
+    }
+
+    inline bool operator!=(const Handle& other) const
+    {
+        return value != other.value;
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Keyed, reference counted storage of resources of one type. Slots live in
+// chunks of a deque so resources are constructed in place and never move.
+// Slots whose reference count dropped to zero are only destroyed by Collect
+// after they stayed unreferenced for a number of frames.
+// -----------------------------------------------------------------------------
+template <typename T>
+class ResourcePool
+{
+public:
+
+    // returns the live resource cached under key, or an invalid handle
+    Handle<T> Find(uint64_t key)
+    {
+        auto it = _lookup.find(key);
+        if ( it == _lookup.end() )
+            return Handle<T>();
+
+        Slot& slot = _slots[it->second];
+        ++slot.refCount;
+        return Handle<T>(it->second, slot.generation);
+    }
+
+    // unlike Find this takes no reference
+    inline bool Contains(uint64_t key) const
+    {
+        return _lookup.count(key) != 0;
+    }
+
+    template <typename... Args>
+    Handle<T> Create(uint64_t key, Args&&... args)
+    {
+        uint32_t index = 0;
+        if ( !_freeList.empty() )
+        {
+            index = _freeList.back();
+            _freeList.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)_slots.size();
+            _slots.emplace_back();
+        }
+
+        Slot& slot = _slots[index];
+        slot.resource.emplace(std::forward<Args>(args)...);
+        slot.key      = key;
+        slot.refCount = 1;
+        _lookup[key]  = index;
+        ++_liveCount;
+
+        return Handle<T>(index, slot.generation);
+    }
+
+    inline T* Get(Handle<T> handle)
+    {
+        Slot* slot = GetSlot(handle);
+        return slot ? &*slot->resource : nullptr;
+    }
+
+    void AddRef(Handle<T> handle)
+    {
+        if ( Slot* slot = GetSlot(handle) )
+            ++slot->refCount;
+    }
+
+    void Release(Handle<T> handle, unsigned int frame)
+    {
+        Slot* slot = GetSlot(handle);
+        if ( slot && --slot->refCount == 0 )
+        {
+            slot->releaseFrame = frame;
+            _pending.push_back(handle.GetIndex());
+        }
+    }
+
+    // destroys slots that stayed unreferenced for at least delay frames,
+    // returns the number of destroyed resources
+    size_t Collect(unsigned int frame, unsigned int delay)
+    {
+        size_t destroyed = 0;
+        for ( size_t ii = 0; ii < _pending.size(); )
+        {
+            Slot& slot = _slots[_pending[ii]];
+            bool revived = slot.refCount != 0 || !slot.resource;
+            if ( revived || frame - slot.releaseFrame >= delay )
+            {
+                if ( !revived )
+                {
+                    Destroy(_pending[ii]);
+                    ++destroyed;
+                }
+
+                _pending[ii] = _pending.back();
+                _pending.pop_back();
+            }
+            else
+            {
+                ++ii;
+            }
+        }
+
+        return destroyed;
+    }
+
+    // destroys every resource regardless of references, used at shutdown
+    void Clear()
+    {
+        for ( uint32_t ii = 0; ii < (uint32_t)_slots.size(); ++ii )
+        {
+            if ( _slots[ii].resource )
+                Destroy(ii);
+        }
+
+        _pending.clear();
+    }
+
+    inline size_t GetLiveCount() const
+    {
+        return _liveCount;
+    }
+
+    inline size_t GetPendingCount() const
+    {
+        return _pending.size();
+    }
+
+private:
+
+    struct Slot
+    {
+        std::optional<T>    resource;
+        uint64_t            key          = 0;
+        uint32_t            generation   = 1;
+        uint32_t            refCount     = 0;
+        unsigned int        releaseFrame = 0;
+    };
+
+    inline Slot* GetSlot(Handle<T> handle)
+    {
+        uint32_t index = handle.GetIndex();
+        if ( !handle.IsValid() || index >= _slots.size() )
+            return nullptr;
+
+        Slot& slot = _slots[index];
+        if ( slot.generation != handle.GetGeneration() || !slot.resource )
+            return nullptr;
+
+        return &slot;
+    }
+
+    void Destroy(uint32_t index)
+    {
+        Slot& slot = _slots[index];
+        slot.resource.reset();
+        slot.refCount = 0;
+        slot.generation = (slot.generation + 1) & Handle<T>::GenerationMask;
+        if ( slot.generation == 0 )
+            slot.generation = 1;
+
+        _lookup.erase(slot.key);
+        _freeList.push_back(index);
+        --_liveCount;
+    }
+
+    std::deque<Slot>                        _slots;
+    std::vector<uint32_t>                   _freeList;
+    std::vector<uint32_t>                   _pending;
+    std::unordered_map<uint64_t, uint32_t>  _lookup;
+    size_t                                  _liveCount = 0;
+};
+
+#endif // _resourcepool_h_
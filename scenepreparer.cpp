@@ -0,0 +1,176 @@
+#include "scenepreparer.h"
+
+#include <stb_image.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ScenePreparer::ScenePreparer( unsigned int workerCount )
+{
+    for ( unsigned int ii = 0; ii < workerCount; ++ii )
+        _workers.emplace_back(&ScenePreparer::WorkerMain, this);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ScenePreparer::~ScenePreparer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wake.notify_all();
+
+    for ( std::thread& worker : _workers )
+        worker.join();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ScenePreparer::Prepare(unsigned int scene, const SceneResources& resources)
+{
+    if ( _scenes.count(scene) )
+        return;
+
+    ResourceManager& manager = ResourceManager::Get();
+    Preparation& preparation = _scenes[scene];
+    preparation.generation = ++_generation;
+    std::vector<Job> jobs;
+
+    // anything already cached only needs a reference
+    for ( const std::string& path : resources.textures )
+    {
+        if ( manager.IsTextureLoaded(path) )
+            preparation.textures.push_back(manager.LoadTexture(path));
+        else
+            jobs.push_back({ scene, preparation.generation, Kind::Texture, path });
+    }
+
+    for ( const std::string& path : resources.shaders )
+    {
+        if ( manager.IsShaderLoaded(path) )
+            preparation.shaders.push_back(manager.LoadShader(path));
+        else
+            jobs.push_back({ scene, preparation.generation, Kind::Shader, path });
+    }
+
+    if ( jobs.empty() )
+        return;
+
+    preparation.pending = (unsigned int)jobs.size();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for ( Job& job : jobs )
+            _requests.push_back(std::move(job));
+    }
+    _wake.notify_all();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool ScenePreparer::IsPrepared(unsigned int scene) const
+{
+    auto it = _scenes.find(scene);
+    return it != _scenes.end() && it->second.pending == 0;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool ScenePreparer::IsPreparing(unsigned int scene) const
+{
+    auto it = _scenes.find(scene);
+    return it != _scenes.end() && it->second.pending != 0;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ScenePreparer::Release(unsigned int scene)
+{
+    // results still in flight are dropped when they arrive
+    _scenes.erase(scene);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ScenePreparer::Update(double budgetMs)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto start = Clock::now();
+    ResourceManager& manager = ResourceManager::Get();
+
+    for ( ;; )
+    {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if ( _results.empty() )
+                break;
+            job = std::move(_results.front());
+            _results.pop_front();
+        }
+
+        auto it = _scenes.find(job.scene);
+        if ( it == _scenes.end() || it->second.generation != job.generation )
+            continue;
+
+        // a file that failed to load is left for the scene to report
+        Preparation& preparation = it->second;
+        if ( job.kind == Kind::Texture && !job.pixels.empty() )
+            preparation.textures.push_back(manager.LoadTexture(job.path, job.width, job.height, job.pixels.data()));
+        else if ( job.kind == Kind::Shader && !job.source.empty() )
+            preparation.shaders.push_back(manager.LoadShader(job.path, job.source));
+        --preparation.pending;
+
+        if ( std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= budgetMs )
+            break;
+    }
+
+    _lastUploadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ScenePreparer::Load(Job& job)
+{
+    if ( job.kind == Kind::Texture )
+    {
+        int bpp = 0;
+        if ( unsigned char* pixels = stbi_load(job.path.c_str(), &job.width, &job.height, &bpp, 4) )
+        {
+            job.pixels.assign(pixels, pixels + (size_t)job.width * job.height * 4u);
+            stbi_image_free(pixels);
+        }
+    }
+    else
+    {
+        std::ifstream stream(job.path, std::ios::binary);
+        job.source.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ScenePreparer::WorkerMain()
+{
+    for ( ;; )
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]() { return _quit || !_requests.empty(); });
+            if ( _quit )
+                return;
+            job = std::move(_requests.front());
+            _requests.pop_front();
+        }
+
+        Load(job);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _results.push_back(std::move(job));
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef _scenepreparer_h_
+#define _scenepreparer_h_
+
+#include "resourcemanager.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Files a scene loads through the ResourceManager, declared before it is
+// constructed so they can be loaded ahead of time.
+// -----------------------------------------------------------------------------
+struct SceneResources
+{
+    std::vector<std::string>    textures;
+    std::vector<std::string>    shaders;
+};
+
+// -----------------------------------------------------------------------------
+// Loads the declared resources of scenes in the background. Worker threads
+// read shader files and decode images; Update creates the GL objects on the
+// GL thread within a time budget per frame. The objects go into the
+// ResourceManager cache, so the Load calls in the scene's constructor hit,
+// and references are held until the scene is released.
+// -----------------------------------------------------------------------------
+class ScenePreparer
+{
+public:
+
+    explicit ScenePreparer( unsigned int workerCount = 2 );
+    ~ScenePreparer();
+
+    // scene is any id chosen by the caller, preparing it again is a no-op
+    void Prepare(unsigned int scene, const SceneResources& resources);
+    bool IsPrepared(unsigned int scene) const;
+    bool IsPreparing(unsigned int scene) const;
+
+    // drops the references held for the scene
+    void Release(unsigned int scene);
+
+    // call once per frame on the GL thread, creates at least one object
+    void Update(double budgetMs);
+
+    inline double GetLastUploadMs() const
+    {
+        return _lastUploadMs;
+    }
+
+private:
+
+    enum class Kind
+    {
+        Texture,
+        Shader
+    };
+
+    struct Job
+    {
+        unsigned int                scene;
+        unsigned int                generation;     // stale once the scene was released
+        Kind                        kind;
+        std::string                 path;
+
+        // filled in by the worker
+        std::vector<unsigned char>  pixels;
+        int                         width   = 0;
+        int                         height  = 0;
+        std::string                 source;
+    };
+
+    struct Preparation
+    {
+        std::vector<ResourceRef<Texture>>   textures;
+        std::vector<ResourceRef<Shader>>    shaders;
+        unsigned int                        generation  = 0;
+        unsigned int                        pending     = 0;
+    };
+
+    void WorkerMain();
+    void Load(Job& job);
+
+    std::unordered_map<unsigned int, Preparation>   _scenes;
+    double                                          _lastUploadMs   = 0.0;
+    unsigned int                                    _generation     = 0;
+
+    // shared with the workers
+    std::vector<std::thread>        _workers;
+    std::mutex                      _mutex;
+    std::condition_variable         _wake;
+    std::deque<Job>                 _requests;
+    std::deque<Job>                 _results;
+    bool                            _quit           = false;
+};
+
+#endif // _scenepreparer_h_
@@ -0,0 +1,183 @@
+#include "renderer.h"
+#include "sdffont.h"
+#include "resourcememory.h"
+
+#include <imgui.h>
+
+#include <fstream>
+#include <iostream>
+
+// imgui_draw.cpp compiles its own static copies, keep ours private to this
+// translation unit as well
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imstb_rectpack.h>
+
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <imstb_truetype.h>
+
+namespace
+{
+
+// distance field spread in texels on either side of the outline
+const int           s_padding       = 6;
+const unsigned char s_onEdge        = 128;
+const float         s_distanceScale = (float)s_onEdge / s_padding;
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+struct SdfFont::Backend
+{
+    std::vector<unsigned char>  ttf;
+    stbtt_fontinfo              info;
+    stbrp_context               packer;
+    std::vector<stbrp_node>     nodes;
+};
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+SdfFont::SdfFont(const std::string& path, float bakeSize, unsigned int atlasSize)
+    : _backend(std::make_unique<Backend>()),
+      _atlasSize(atlasSize),
+      _bakeSize(bakeSize)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if ( stream )
+        _backend->ttf.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+    if ( _backend->ttf.empty() || !stbtt_InitFont(&_backend->info, _backend->ttf.data(), 0) )
+    {
+        // the atlas keeps the decompressed ttf of its default font around
+        const ImFontAtlas* fonts = ImGui::GetIO().Fonts;
+        if ( fonts->ConfigData.empty() )
+        {
+            std::cout << "[SdfFont] no font available for " << path << std::endl;
+            return;
+        }
+
+        const ImFontConfig& config = fonts->ConfigData[0];
+        const unsigned char* data = (const unsigned char*)config.FontData;
+        _backend->ttf.assign(data, data + config.FontDataSize);
+        stbtt_InitFont(&_backend->info, _backend->ttf.data(), 0);
+        _fallback = true;
+    }
+
+    int ascent = 0, descent = 0, lineGap = 0;
+    stbtt_GetFontVMetrics(&_backend->info, &ascent, &descent, &lineGap);
+    _scale = stbtt_ScaleForPixelHeight(&_backend->info, _bakeSize);
+    _lineHeight = (ascent - descent + lineGap) * _scale;
+
+    glGenTextures(1, &_atlasID);
+    glBindTexture(GL_TEXTURE_2D, _atlasID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, _atlasSize, _atlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    ResourceMemory::Allocate(ResourceMemory::Category::Texture, (size_t)_atlasSize * _atlasSize);
+
+    Reset();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+SdfFont::~SdfFont()
+{
+    if ( _atlasID )
+    {
+        glDeleteTextures(1, &_atlasID);
+        ResourceMemory::Free(ResourceMemory::Category::Texture, (size_t)_atlasSize * _atlasSize);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void SdfFont::Reset()
+{
+    _backend->nodes.resize(_atlasSize);
+    stbrp_init_target(&_backend->packer, _atlasSize, _atlasSize, _backend->nodes.data(), (int)_backend->nodes.size());
+    _glyphs.clear();
+    _full = false;
+    ++_generation;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const SdfGlyph* SdfFont::GetGlyph(uint32_t codepoint)
+{
+    auto it = _glyphs.find(codepoint);
+    if ( it != _glyphs.end() )
+    {
+        ++_hits;
+        return &it->second;
+    }
+
+    if ( _full || !_atlasID )
+        return nullptr;
+
+    ++_misses;
+
+    SdfGlyph glyph = {};
+    int advance = 0, bearing = 0;
+    stbtt_GetCodepointHMetrics(&_backend->info, (int)codepoint, &advance, &bearing);
+    glyph.advance = advance * _scale;
+
+    int width = 0, height = 0, xoff = 0, yoff = 0;
+    unsigned char* sdf = stbtt_GetCodepointSDF(&_backend->info, _scale, (int)codepoint, s_padding, s_onEdge,
+                                               s_distanceScale, &width, &height, &xoff, &yoff);
+    if ( sdf )
+    {
+        // one texel gap so bilinear filtering does not bleed between glyphs
+        stbrp_rect rect = {};
+        rect.w = (stbrp_coord)(width + 1);
+        rect.h = (stbrp_coord)(height + 1);
+        stbrp_pack_rects(&_backend->packer, &rect, 1);
+        if ( !rect.was_packed )
+        {
+            stbtt_FreeSDF(sdf, nullptr);
+            _full = true;
+            return nullptr;
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glBindTexture(GL_TEXTURE_2D, _atlasID);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, width, height, GL_RED, GL_UNSIGNED_BYTE, sdf);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        stbtt_FreeSDF(sdf, nullptr);
+
+        // bitmap rows run top down from yoff below the baseline
+        float inverse = 1.0f / _atlasSize;
+        glyph.x0 = (float)xoff;
+        glyph.x1 = (float)(xoff + width);
+        glyph.y0 = (float)(-yoff - height);
+        glyph.y1 = (float)(-yoff);
+        glyph.u0 = rect.x * inverse;
+        glyph.u1 = (rect.x + width) * inverse;
+        glyph.v0 = (rect.y + height) * inverse;
+        glyph.v1 = rect.y * inverse;
+        glyph.visible = true;
+    }
+
+    return &_glyphs.emplace(codepoint, glyph).first->second;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+float SdfFont::GetKerning(uint32_t left, uint32_t right) const
+{
+    return stbtt_GetCodepointKernAdvance(&_backend->info, (int)left, (int)right) * _scale;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void SdfFont::Bind(unsigned int slot) const
+{
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_2D, _atlasID);
+}
@@ -0,0 +1,107 @@
+#ifndef _sdffont_h_
+#define _sdffont_h_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Glyph of an SdfFont. The quad is relative to the pen position on the
+// baseline at the bake size with y pointing up.
+// -----------------------------------------------------------------------------
+struct SdfGlyph
+{
+    float   x0, y0, x1, y1;
+    float   u0, v0, u1, v1;
+    float   advance;
+    bool    visible;
+};
+
+// -----------------------------------------------------------------------------
+// TrueType font rasterized on demand into a single channel signed distance
+// field atlas. Glyphs are packed as they are first requested; when the atlas
+// is full further glyphs are refused until Reset() starts it over, which also
+// bumps the generation so cached layouts can tell their UVs are stale.
+// -----------------------------------------------------------------------------
+class SdfFont
+{
+public:
+
+    // falls back to ImGui's built in font when path can not be read
+    SdfFont(const std::string& path, float bakeSize = 32.0f, unsigned int atlasSize = 1024);
+    ~SdfFont();
+
+    // nullptr when the atlas has no room left for a new glyph
+    const SdfGlyph* GetGlyph(uint32_t codepoint);
+    float GetKerning(uint32_t left, uint32_t right) const;
+
+    void Bind(unsigned int slot = 0) const;
+    void Reset();
+
+    inline float GetBakeSize() const
+    {
+        return _bakeSize;
+    }
+
+    inline float GetLineHeight() const
+    {
+        return _lineHeight;
+    }
+
+    inline uint32_t GetGeneration() const
+    {
+        return _generation;
+    }
+
+    inline bool IsFull() const
+    {
+        return _full;
+    }
+
+    inline bool IsFallback() const
+    {
+        return _fallback;
+    }
+
+    inline unsigned int GetGlyphCount() const
+    {
+        return (unsigned int)_glyphs.size();
+    }
+
+    inline uint64_t GetHits() const
+    {
+        return _hits;
+    }
+
+    inline uint64_t GetMisses() const
+    {
+        return _misses;
+    }
+
+    inline void ResetCounters()
+    {
+        _hits = _misses = 0;
+    }
+
+private:
+
+    struct Backend;
+
+    std::unique_ptr<Backend>                _backend;
+    std::unordered_map<uint32_t, SdfGlyph>  _glyphs;
+
+    unsigned int    _atlasID        = 0;
+    unsigned int    _atlasSize      = 0;
+    float           _bakeSize       = 0.0f;
+    float           _scale          = 0.0f;
+    float           _lineHeight     = 0.0f;
+    uint32_t        _generation     = 0;
+    bool            _full           = false;
+    bool            _fallback       = false;
+    uint64_t        _hits           = 0;
+    uint64_t        _misses         = 0;
+};
+
+#endif // _sdffont_h_
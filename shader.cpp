@@ -1,14 +1,35 @@
 #include <iostream>
 #include "renderer.h"
 #include "shader.h"
+#include "glcapture.h"
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 Shader::Shader(const std::string& filepath)
     : _filePath(filepath)
 {
-    auto[vertexSource, fragmentSource] = ParseShader(filepath);
-    _rendererID = CreateShader(vertexSource, fragmentSource);
+    std::ifstream stream(filepath);
+    Create(stream);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Shader::Shader(const std::string& name, const std::string& source)
+    : _filePath(name)
+{
+    std::istringstream stream(source);
+    Create(stream);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Shader::Create(std::istream& stream)
+{
+    auto[vertexSource, fragmentSource, computeSource, feedbackVaryings] = ParseShader(stream);
+    if ( !computeSource.empty() )
+        _rendererID = CreateComputeShader(computeSource);
+    else
+        _rendererID = CreateShader(vertexSource, fragmentSource, feedbackVaryings);
 }
 
 // -----------------------------------------------------------------------------
@@ -16,13 +37,15 @@ Shader::Shader(const std::string& filepath)
 Shader::~Shader()
 {
     glDeleteProgram(_rendererID);
+    GLCapture::DeleteProgram(_rendererID);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void Shader::Bind() const
+void Shader::Bind(GLDebug::Caller caller) const
 {
-    glUseProgram(_rendererID);
+    GLCallFrom(caller, glUseProgram(_rendererID));
+    GLCapture::UseProgram(_rendererID, _filePath);
 }
 
 // -----------------------------------------------------------------------------
@@ -34,81 +57,132 @@ void Shader::Unbind() const
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void Shader::SetUniform1i(const std::string& name, int i0)
+void Shader::SetUniform1i(const char* name, int i0, GLDebug::Caller caller)
 {
-    glUniform1i(GetUniformLocation(name), i0);
+    int location = GetUniformLocation(name);
+    GLCallFrom(caller, glUniform1i(location, i0));
+    GLCapture::Uniform(_rendererID, location, name, TraceUniform::Int, 1, &i0);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void Shader::SetUniform1f(const std::string& name, float f0)
+void Shader::SetUniform1f(const char* name, float f0, GLDebug::Caller caller)
 {
-    glUniform1f(GetUniformLocation(name), f0);
+    int location = GetUniformLocation(name);
+    GLCallFrom(caller, glUniform1f(location, f0));
+    GLCapture::Uniform(_rendererID, location, name, TraceUniform::Float, 1, &f0);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void Shader::SetUniform4f(const std::string& name, float f0, float f1, float f2, float f3)
+void Shader::SetUniform2f(const char* name, float f0, float f1, GLDebug::Caller caller)
 {
-    glUniform4f(GetUniformLocation(name), f0, f1, f2, f3);
+    int location = GetUniformLocation(name);
+    GLCallFrom(caller, glUniform2f(location, f0, f1));
+    float values[] = { f0, f1 };
+    GLCapture::Uniform(_rendererID, location, name, TraceUniform::Vec2, 1, values);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& mat)
+void Shader::SetUniform4f(const char* name, float f0, float f1, float f2, float f3, GLDebug::Caller caller)
 {
-    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+    int location = GetUniformLocation(name);
+    GLCallFrom(caller, glUniform4f(location, f0, f1, f2, f3));
+    float values[] = { f0, f1, f2, f3 };
+    GLCapture::Uniform(_rendererID, location, name, TraceUniform::Vec4, 1, values);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-int Shader::GetUniformLocation(const std::string& name)
+void Shader::SetUniformMat4f(const char* name, const glm::mat4& mat, GLDebug::Caller caller)
 {
-    int location = -1;
+    int location = GetUniformLocation(name);
+    GLCallFrom(caller, glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]));
+    GLCapture::Uniform(_rendererID, location, name, TraceUniform::Mat4, 1, &mat[0][0]);
+}
 
-    auto it = _uniformLocationCache.find(name);
-    if ( it != _uniformLocationCache.end() )
-        location  = it->second;
-    else
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Shader::SetUniform1ui(const char* name, unsigned int u0, GLDebug::Caller caller)
+{
+    int location = GetUniformLocation(name);
+    GLCallFrom(caller, glUniform1ui(location, u0));
+    GLCapture::Uniform(_rendererID, location, name, TraceUniform::UInt, 1, &u0);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Shader::SetUniform4fv(const char* name, int count, const float* values, GLDebug::Caller caller)
+{
+    int location = GetUniformLocation(name);
+    GLCallFrom(caller, glUniform4fv(location, count, values));
+    GLCapture::Uniform(_rendererID, location, name, TraceUniform::Vec4, (unsigned int)count, values);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+int Shader::GetUniformLocation(const char* name)
+{
+    uint32_t hash = 2166136261u;
+    for ( const char* c = name; *c; ++c )
+    {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+
+    for ( const auto& entry : _uniformLocationCache )
     {
-        location = glGetUniformLocation(_rendererID, name.c_str());
-        _uniformLocationCache[name] = location;
+        if ( entry.hash == hash && entry.name == name )
+            return entry.location;
     }
 
+    int location = glGetUniformLocation(_rendererID, name);
+    _uniformLocationCache.push_back({ hash, location, name });
+
     return location;
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-std::tuple<std::string, std::string> Shader::ParseShader(const std::string& filepath)
+std::tuple<std::string, std::string, std::string, std::vector<std::string>> Shader::ParseShader(std::istream& stream)
 {
-    std::ifstream stream(filepath);
-
     enum class ShaderType
     {
-        NONE = -1, VERTEX = 0, FRAGMENT = 1
+        NONE = -1, VERTEX = 0, FRAGMENT = 1, COMPUTE = 2
     };
 
     std::string line;
-    std::stringstream ss[2];
+    std::stringstream ss[3];
+    std::vector<std::string> varyings;
 
     ShaderType type = ShaderType::NONE;
     while (getline(stream, line))
     {
-        if ( line.find("#shader") != std::string::npos )
+        if ( line.find("#feedback") != std::string::npos )
+        {
+            // #feedback name0 name1 ... captured interleaved in that order
+            std::stringstream names(line.substr(line.find("#feedback") + 9));
+            std::string name;
+            while ( names >> name )
+                varyings.push_back(name);
+        }
+        else if ( line.find("#shader") != std::string::npos )
         {
             if ( line.find("vertex") != std::string::npos )
                 type = ShaderType::VERTEX;
             if ( line.find("fragment") != std::string::npos )
                 type = ShaderType::FRAGMENT;
+            if ( line.find("compute") != std::string::npos )
+                type = ShaderType::COMPUTE;
         }
-        else
+        else if ( type != ShaderType::NONE )
         {
             ss[(int)type] << line << "\n";
         }
     }
 
-    return { ss[0].str(), ss[1].str() };
+    return { ss[0].str(), ss[1].str(), ss[2].str(), varyings };
 }
 
 // -----------------------------------------------------------------------------
@@ -128,7 +202,7 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
         glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
         char *message = (char *)alloca(length * sizeof(char));
         glGetShaderInfoLog(id, length, &length, message);
-        std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragement") << " shader!\n";
+        std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : type == GL_COMPUTE_SHADER ? "compute" : "fragement") << " shader!\n";
         std::cout << message << "\n";
         glDeleteShader(id);
         return 0;
@@ -140,19 +214,69 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 unsigned int Shader::CreateShader( const std::string& vertexShader,
-                                   const std::string& fragmentShader )
+                                   const std::string& fragmentShader,
+                                   const std::vector<std::string>& feedbackVaryings )
 {
     unsigned int program = glCreateProgram();
     unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
     glAttachShader(program, vs);
-    glAttachShader(program, fs);
+
+    // transform feedback programs may run without a fragment stage
+    unsigned int fs = 0;
+    if ( !fragmentShader.empty() )
+    {
+        fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+        glAttachShader(program, fs);
+    }
+
+    if ( !feedbackVaryings.empty() )
+    {
+        std::vector<const char*> names;
+        for ( const auto& name : feedbackVaryings )
+            names.push_back(name.c_str());
+        glTransformFeedbackVaryings(program, (GLsizei)names.size(), names.data(), GL_INTERLEAVED_ATTRIBS);
+    }
+
     glLinkProgram(program);
     glValidateProgram(program);
 
     glDeleteShader(vs);
-    glDeleteShader(fs);
+    if ( fs )
+        glDeleteShader(fs);
+
+    int result;
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+    if ( result == GL_FALSE )
+    {
+        std::cout << "Failed to link shader " << _filePath << "\n";
+        glDeleteProgram(program);
+        return 0;
+    }
 
     return program;
 }
 
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+unsigned int Shader::CreateComputeShader( const std::string& computeShader )
+{
+    unsigned int cs = CompileShader(GL_COMPUTE_SHADER, computeShader);
+    if ( cs == 0 )
+        return 0;
+
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, cs);
+    glLinkProgram(program);
+    glDeleteShader(cs);
+
+    int result;
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+    if ( result == GL_FALSE )
+    {
+        std::cout << "Failed to link compute shader " << _filePath << "\n";
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
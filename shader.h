@@ -5,10 +5,13 @@
 #include <fstream>
 #include <sstream>
 #include <tuple>
-#include <unordered_map>
+#include <vector>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 
+#include "gldebug.h"
+
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 class Shader
@@ -16,28 +19,55 @@ class Shader
 public:
 
     Shader(const std::string& filepath);
+    // from the text of a .shader file, name is only used in messages
+    Shader(const std::string& name, const std::string& source);
     ~Shader();
 
-    void Bind() const;
+    void Bind(GLDebug::Caller caller = {}) const;
     void Unbind() const;
 
+    inline bool IsValid() const
+    {
+        return _rendererID != 0;
+    }
+
+    inline unsigned int GetRendererID() const
+    {
+        return _rendererID;
+    }
+
     // Set uniforms
-    void SetUniform1i(const std::string& name, int i0);
-    void SetUniform1f(const std::string& name, float f0);
-    void SetUniform4f(const std::string& name, float f0, float f1, float f2, float f3);
-    void SetUniformMat4f(const std::string& name, const glm::mat4& mat);
+    void SetUniform1i(const char* name, int i0, GLDebug::Caller caller = {});
+    void SetUniform1f(const char* name, float f0, GLDebug::Caller caller = {});
+    void SetUniform2f(const char* name, float f0, float f1, GLDebug::Caller caller = {});
+    void SetUniform4f(const char* name, float f0, float f1, float f2, float f3, GLDebug::Caller caller = {});
+    void SetUniformMat4f(const char* name, const glm::mat4& mat, GLDebug::Caller caller = {});
+    void SetUniform1ui(const char* name, unsigned int u0, GLDebug::Caller caller = {});
+    void SetUniform4fv(const char* name, int count, const float* values, GLDebug::Caller caller = {});
 
 private:
 
-    std::tuple<std::string, std::string> ParseShader(const std::string& filepath);
+    // vertex, fragment and compute sources plus transform feedback varyings
+    void Create(std::istream& stream);
+    std::tuple<std::string, std::string, std::string, std::vector<std::string>> ParseShader(std::istream& stream);
     unsigned int CompileShader(unsigned int type, const std::string& source);
     unsigned int CreateShader( const std::string& vertexShader,
-                               const std::string& fragmentShader );
-    int GetUniformLocation(const std::string& name);
+                               const std::string& fragmentShader,
+                               const std::vector<std::string>& feedbackVaryings );
+    unsigned int CreateComputeShader( const std::string& computeShader );
+    int GetUniformLocation(const char* name);
 
     unsigned int    _rendererID = 0;
     std::string     _filePath;
-    std::unordered_map<std::string, int> _uniformLocationCache;
+    // looked up by name hash so setters called with literals never allocate
+    struct UniformLocation
+    {
+        uint32_t    hash;
+        int         location;
+        std::string name;
+    };
+
+    std::vector<UniformLocation> _uniformLocationCache;
 };
 
 #endif // _shader_h_
@@ -0,0 +1,370 @@
+#include "renderer.h"
+#include "staticbatch.h"
+#include "vertexbufferlayout.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+inline uint16_t ToUnorm16(float value)
+{
+    return (uint16_t)(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+std::vector<unsigned int> MakeQuadIndices(unsigned int quads)
+{
+    std::vector<unsigned int> indices((size_t)quads * 6u);
+    for ( unsigned int qq = 0; qq < quads; ++qq )
+    {
+        unsigned int* index = &indices[(size_t)qq * 6u];
+        unsigned int base = qq * 4u;
+        index[0] = base + 0;
+        index[1] = base + 1;
+        index[2] = base + 2;
+        index[3] = base + 2;
+        index[4] = base + 3;
+        index[5] = base + 0;
+    }
+
+    return indices;
+}
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+StaticBatch::StaticBatch(float chunkSize, unsigned int chunkCapacity)
+    : _chunkSize(chunkSize),
+      _chunkCapacity(std::max(chunkCapacity, 1u))
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+StaticBatch::~StaticBatch()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::WriteQuad(const Sprite& sprite, Vertex* out)
+{
+    if ( !sprite.visible )
+    {
+        // degenerate, the slot stays allocated for reuse
+        for ( int vv = 0; vv < 4; ++vv )
+            out[vv] = { sprite.position.x, sprite.position.y, 0, 0, 0 };
+        return;
+    }
+
+    float x0 = sprite.position.x, x1 = sprite.position.x + sprite.size.x;
+    float y0 = sprite.position.y, y1 = sprite.position.y + sprite.size.y;
+    uint16_t u0 = ToUnorm16(sprite.uv.x), v0 = ToUnorm16(sprite.uv.y);
+    uint16_t u1 = ToUnorm16(sprite.uv.z), v1 = ToUnorm16(sprite.uv.w);
+
+    out[0] = { x0, y0, u0, v0, sprite.color };
+    out[1] = { x1, y0, u1, v0, sprite.color };
+    out[2] = { x1, y1, u1, v1, sprite.color };
+    out[3] = { x0, y1, u0, v1, sprite.color };
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+unsigned int StaticBatch::FindChunk(const glm::vec2& position)
+{
+    int cellX = (int)std::floor(position.x / _chunkSize);
+    int cellY = (int)std::floor(position.y / _chunkSize);
+    uint64_t key = ((uint64_t)(uint32_t)cellY << 32) | (uint32_t)cellX;
+
+    auto it = _chunkLookup.find(key);
+    if ( it != _chunkLookup.end() )
+        return it->second;
+
+    auto chunk = std::make_unique<Chunk>();
+    chunk->cellX = cellX;
+    chunk->cellY = cellY;
+    chunk->boundsMin = glm::vec2(cellX * _chunkSize, cellY * _chunkSize);
+    chunk->boundsMax = chunk->boundsMin + glm::vec2(_chunkSize, _chunkSize);
+    chunk->capacity = _chunkCapacity;
+
+    unsigned int index = (unsigned int)_chunks.size();
+    _chunks.push_back(std::move(chunk));
+    _chunkLookup.emplace(key, index);
+    return index;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+unsigned int StaticBatch::Insert(unsigned int index, const Sprite& sprite)
+{
+    Chunk& chunk = *_chunks[index];
+
+    unsigned int slot;
+    if ( !chunk.freeSlots.empty() )
+    {
+        slot = chunk.freeSlots.back();
+        chunk.freeSlots.pop_back();
+        chunk.sprites[slot] = sprite;
+    }
+    else
+    {
+        slot = (unsigned int)chunk.sprites.size();
+        chunk.sprites.push_back(sprite);
+
+        // outgrew its buffer, the next update reallocates and uploads it all
+        if ( slot >= chunk.capacity )
+        {
+            chunk.capacity *= 2;
+            chunk.reallocate = true;
+        }
+    }
+
+    // sprites may hang over the chunk edge
+    chunk.boundsMin = glm::min(chunk.boundsMin, sprite.position);
+    chunk.boundsMax = glm::max(chunk.boundsMax, sprite.position + sprite.size);
+
+    MarkDirty(index, slot);
+    return slot;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::MarkDirty(unsigned int index, unsigned int slot)
+{
+    Chunk& chunk = *_chunks[index];
+    if ( !chunk.listed )
+    {
+        chunk.listed = true;
+        _dirtyChunks.push_back(index);
+    }
+
+    Sprite& sprite = chunk.sprites[slot];
+    if ( !sprite.dirty && !chunk.reallocate )
+    {
+        sprite.dirty = true;
+        chunk.dirtySlots.push_back(slot);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+unsigned int StaticBatch::Add(const glm::vec2& position, const glm::vec2& size, const glm::vec4& uv,
+                              uint32_t color)
+{
+    Sprite sprite;
+    sprite.position = position;
+    sprite.size = size;
+    sprite.uv = uv;
+    sprite.color = color;
+
+    unsigned int chunk = FindChunk(position);
+    SpriteRef ref = { chunk, Insert(chunk, sprite) };
+
+    unsigned int id;
+    if ( !_freeIds.empty() )
+    {
+        id = _freeIds.back();
+        _freeIds.pop_back();
+        _refs[id] = ref;
+    }
+    else
+    {
+        id = (unsigned int)_refs.size();
+        _refs.push_back(ref);
+    }
+
+    ++_spriteCount;
+    return id;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const StaticBatch::Sprite& StaticBatch::Get(unsigned int id) const
+{
+    const SpriteRef& ref = _refs[id];
+    return _chunks[ref.chunk]->sprites[ref.slot];
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::Set(unsigned int id, const glm::vec2& position, const glm::vec2& size, const glm::vec4& uv,
+                      uint32_t color)
+{
+    SpriteRef& ref = _refs[id];
+    assert(ref.chunk != s_invalid);
+
+    unsigned int chunk = FindChunk(position);
+    if ( chunk != ref.chunk )
+    {
+        // moved into another chunk, hide the old quad and insert anew
+        Chunk& previous = *_chunks[ref.chunk];
+        previous.sprites[ref.slot].visible = false;
+        previous.freeSlots.push_back(ref.slot);
+        MarkDirty(ref.chunk, ref.slot);
+
+        Sprite sprite;
+        sprite.position = position;
+        sprite.size = size;
+        sprite.uv = uv;
+        sprite.color = color;
+        ref = { chunk, Insert(chunk, sprite) };
+        return;
+    }
+
+    Chunk& current = *_chunks[chunk];
+    Sprite& sprite = current.sprites[ref.slot];
+    sprite.position = position;
+    sprite.size = size;
+    sprite.uv = uv;
+    sprite.color = color;
+    current.boundsMin = glm::min(current.boundsMin, position);
+    current.boundsMax = glm::max(current.boundsMax, position + size);
+    MarkDirty(chunk, ref.slot);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::SetUV(unsigned int id, const glm::vec4& uv)
+{
+    const SpriteRef& ref = _refs[id];
+    _chunks[ref.chunk]->sprites[ref.slot].uv = uv;
+    MarkDirty(ref.chunk, ref.slot);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::SetColor(unsigned int id, uint32_t color)
+{
+    const SpriteRef& ref = _refs[id];
+    _chunks[ref.chunk]->sprites[ref.slot].color = color;
+    MarkDirty(ref.chunk, ref.slot);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::Remove(unsigned int id)
+{
+    SpriteRef& ref = _refs[id];
+    assert(ref.chunk != s_invalid);
+
+    Chunk& chunk = *_chunks[ref.chunk];
+    chunk.sprites[ref.slot].visible = false;
+    chunk.freeSlots.push_back(ref.slot);
+    MarkDirty(ref.chunk, ref.slot);
+
+    ref = { s_invalid, s_invalid };
+    _freeIds.push_back(id);
+    --_spriteCount;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::UploadChunk(Chunk& chunk)
+{
+    const unsigned int quadBytes = 4u * (unsigned int)sizeof(Vertex);
+
+    if ( chunk.reallocate )
+    {
+        chunk.vbo = std::make_unique<VertexBuffer>(nullptr, chunk.capacity * quadBytes, GL_DYNAMIC_DRAW);
+        chunk.vao = std::make_unique<VertexArray>();
+
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<unsigned short>(2);
+        layout.Push<unsigned char>(4);
+        chunk.vao->AddBuffer(*chunk.vbo, layout);
+
+        _scratch.resize(chunk.sprites.size() * 4u);
+        for ( size_t ss = 0; ss < chunk.sprites.size(); ++ss )
+        {
+            WriteQuad(chunk.sprites[ss], &_scratch[ss * 4u]);
+            chunk.sprites[ss].dirty = false;
+        }
+
+        chunk.vbo->SetSubData(0, (unsigned int)chunk.sprites.size() * quadBytes, _scratch.data());
+        _uploadedBytes += chunk.sprites.size() * quadBytes;
+        ++_uploadRanges;
+
+        chunk.dirtySlots.clear();
+        chunk.reallocate = false;
+        return;
+    }
+
+    // coalesce nearby dirty quads into ranges
+    std::sort(chunk.dirtySlots.begin(), chunk.dirtySlots.end());
+    size_t ii = 0;
+    while ( ii < chunk.dirtySlots.size() )
+    {
+        unsigned int first = chunk.dirtySlots[ii], last = first;
+        for ( ++ii; ii < chunk.dirtySlots.size() && chunk.dirtySlots[ii] - last <= s_mergeGap; ++ii )
+            last = chunk.dirtySlots[ii];
+
+        unsigned int count = last - first + 1;
+        _scratch.resize((size_t)count * 4u);
+        for ( unsigned int ss = 0; ss < count; ++ss )
+        {
+            Sprite& sprite = chunk.sprites[first + ss];
+            WriteQuad(sprite, &_scratch[(size_t)ss * 4u]);
+            sprite.dirty = false;
+        }
+
+        chunk.vbo->SetSubData(first * quadBytes, count * quadBytes, _scratch.data());
+        _uploadedBytes += (size_t)count * quadBytes;
+        ++_uploadRanges;
+    }
+
+    chunk.dirtySlots.clear();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::Update()
+{
+    _uploadedBytes = 0;
+    _uploadRanges = 0;
+    _dirtyChunkCount = (unsigned int)_dirtyChunks.size();
+
+    for ( unsigned int index : _dirtyChunks )
+    {
+        Chunk& chunk = *_chunks[index];
+        UploadChunk(chunk);
+        chunk.listed = false;
+
+        if ( chunk.capacity > _iboQuads )
+        {
+            _iboQuads = chunk.capacity;
+            std::vector<unsigned int> indices = MakeQuadIndices(_iboQuads);
+            _ibo = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+        }
+    }
+
+    _dirtyChunks.clear();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void StaticBatch::Draw(const Shader& shader, const glm::vec2& visibleMin, const glm::vec2& visibleMax)
+{
+    Renderer renderer;
+
+    _drawnChunks = 0;
+    for ( const auto& chunk : _chunks )
+    {
+        if ( !chunk->vao || chunk->sprites.empty() )
+            continue;
+
+        if ( chunk->boundsMax.x < visibleMin.x || chunk->boundsMin.x > visibleMax.x ||
+             chunk->boundsMax.y < visibleMin.y || chunk->boundsMin.y > visibleMax.y )
+            continue;
+
+        renderer.Draw(*chunk->vao, *_ibo, shader, (unsigned int)chunk->sprites.size() * 6u);
+        ++_drawnChunks;
+    }
+}
@@ -0,0 +1,152 @@
+#ifndef _staticbatch_h_
+#define _staticbatch_h_
+
+#include "vertexarray.h"
+#include "vertexbuffer.h"
+#include "indexbuffer.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Retained geometry for sprites that rarely change, such as tile maps. Sprites
+// are sorted into square chunks by position and every chunk keeps its own
+// vertex buffer on the GPU. Changing a sprite only marks its quad dirty;
+// Update() rewrites the dirty ranges of the dirty chunks with
+// glBufferSubData, so a frame with a few edits uploads a few hundred bytes.
+// -----------------------------------------------------------------------------
+class StaticBatch
+{
+public:
+
+    // uv rect is (u0, v0, u1, v1), color is packed RGBA8
+    struct Sprite
+    {
+        glm::vec2   position;
+        glm::vec2   size;
+        glm::vec4   uv;
+        uint32_t    color   = 0xFFFFFFFFu;
+        bool        visible = true;
+        bool        dirty   = false;
+    };
+
+    StaticBatch(float chunkSize, unsigned int chunkCapacity = 1024);
+    ~StaticBatch();
+
+    // returns the sprite id
+    unsigned int Add(const glm::vec2& position, const glm::vec2& size, const glm::vec4& uv,
+                     uint32_t color = 0xFFFFFFFFu);
+    void Set(unsigned int id, const glm::vec2& position, const glm::vec2& size, const glm::vec4& uv,
+             uint32_t color);
+    void SetUV(unsigned int id, const glm::vec4& uv);
+    void SetColor(unsigned int id, uint32_t color);
+    void Remove(unsigned int id);
+
+    const Sprite& Get(unsigned int id) const;
+
+    void Update();
+    // draws the chunks overlapping the visible rectangle
+    void Draw(const Shader& shader, const glm::vec2& visibleMin, const glm::vec2& visibleMax);
+
+    inline unsigned int GetChunkCount() const
+    {
+        return (unsigned int)_chunks.size();
+    }
+
+    inline unsigned int GetSpriteCount() const
+    {
+        return _spriteCount;
+    }
+
+    inline size_t GetUploadedBytes() const
+    {
+        return _uploadedBytes;
+    }
+
+    inline unsigned int GetUploadRanges() const
+    {
+        return _uploadRanges;
+    }
+
+    inline unsigned int GetDirtyChunks() const
+    {
+        return _dirtyChunkCount;
+    }
+
+    inline unsigned int GetDrawnChunks() const
+    {
+        return _drawnChunks;
+    }
+
+    // 16 bytes, uvs as normalized shorts
+    struct Vertex
+    {
+        float       x, y;
+        uint16_t    u, v;
+        uint32_t    color;
+    };
+
+    static void WriteQuad(const Sprite& sprite, Vertex* out);
+
+private:
+
+    struct Chunk
+    {
+        int                             cellX       = 0;
+        int                             cellY       = 0;
+        glm::vec2                       boundsMin;
+        glm::vec2                       boundsMax;
+        std::vector<Sprite>             sprites;
+        std::vector<unsigned int>       freeSlots;
+        std::vector<unsigned int>       dirtySlots;
+        std::unique_ptr<VertexArray>    vao;
+        std::unique_ptr<VertexBuffer>   vbo;
+        unsigned int                    capacity    = 0;
+        bool                            listed      = false;
+        bool                            reallocate  = true;
+    };
+
+    struct SpriteRef
+    {
+        unsigned int    chunk;
+        unsigned int    slot;
+    };
+
+    unsigned int FindChunk(const glm::vec2& position);
+    unsigned int Insert(unsigned int chunk, const Sprite& sprite);
+    void MarkDirty(unsigned int chunk, unsigned int slot);
+    void UploadChunk(Chunk& chunk);
+
+    float                               _chunkSize;
+    unsigned int                        _chunkCapacity;
+
+    std::vector<std::unique_ptr<Chunk>> _chunks;
+    std::unordered_map<uint64_t, unsigned int> _chunkLookup;
+    std::vector<unsigned int>           _dirtyChunks;
+
+    std::vector<SpriteRef>              _refs;
+    std::vector<unsigned int>           _freeIds;
+    unsigned int                        _spriteCount    = 0;
+
+    // every chunk draws with the same quad index pattern
+    std::unique_ptr<IndexBuffer>        _ibo;
+    unsigned int                        _iboQuads       = 0;
+
+    std::vector<Vertex>                 _scratch;
+
+    size_t                              _uploadedBytes      = 0;
+    unsigned int                        _uploadRanges       = 0;
+    unsigned int                        _dirtyChunkCount    = 0;
+    unsigned int                        _drawnChunks        = 0;
+
+    // dirty quads closer than this are uploaded as one range
+    static constexpr unsigned int       s_mergeGap          = 8;
+    static constexpr unsigned int       s_invalid           = 0xFFFFFFFFu;
+};
+
+#endif // _staticbatch_h_
@@ -1,13 +1,17 @@
 #include "test.h"
+#include "../scenepreparer.h"
 #include <imgui.h>
 
+#include <algorithm>
+
 namespace test
 {
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 TestMenu::TestMenu(Test*& currentTest)
-    : _currentTest(currentTest)
+    : _currentTest(currentTest),
+      _preparer(std::make_unique<ScenePreparer>())
 {
 }
 
@@ -15,20 +19,203 @@ TestMenu::TestMenu(Test*& currentTest)
 // -----------------------------------------------------------------------------
 TestMenu::~TestMenu()
 {
+    for ( int ii = 0; ii < (int)_tests.size(); ++ii )
+        Evict(ii);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::Update()
+{
+    // the frame that just ended, so a switch shows up one frame later
+    if ( _measuring )
+    {
+        _currentWorstMs = std::max(_currentWorstMs, ImGui::GetIO().DeltaTime * 1000.0f);
+        if ( _pendingTest < 0 && --_framesToMeasure <= 0 )
+        {
+            int mode = _measuringBackground ? 1 : 0;
+            _lastSwitchMs[mode] = _currentWorstMs;
+            _worstSwitchMs[mode] = std::max(_worstSwitchMs[mode], _currentWorstMs);
+            _measuring = false;
+        }
+    }
+
+    if ( !_background )
+        return;
+
+    _preparer->Update(_uploadBudgetMs);
+
+    if ( _pendingTest >= 0 && _currentTest == this && _preparer->IsPrepared((unsigned int)_pendingTest) )
+        Activate(_pendingTest);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::BeginSwitchMeasurement()
+{
+    _measuring = true;
+    _measuringBackground = _background;
+    _framesToMeasure = s_measuredFrames;
+    _currentWorstMs = 0.0f;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::Prepare(int index)
+{
+    SceneResources resources;
+    if ( _tests[index].declare )
+        _tests[index].declare(resources);
+
+    _preparer->Prepare((unsigned int)index, resources);
+
+    // hovering only prefetches, it never pushes warm instances out
+    if ( std::find(_warm.begin(), _warm.end(), index) != _warm.end() )
+        return;
+
+    _prefetched.erase(std::remove(_prefetched.begin(), _prefetched.end(), index), _prefetched.end());
+    _prefetched.insert(_prefetched.begin(), index);
+
+    while ( (int)_prefetched.size() > s_prefetchCapacity )
+    {
+        int victim = _prefetched.back();
+        _prefetched.pop_back();
+        if ( victim != _pendingTest )
+            _preparer->Release((unsigned int)victim);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::RequestTest(int index)
+{
+    BeginSwitchMeasurement();
+
+    if ( !_background )
+    {
+        Activate(index);
+        return;
+    }
+
+    // switches from Update once the resources are in
+    Prepare(index);
+    _pendingTest = index;
+    if ( _preparer->IsPrepared((unsigned int)index) )
+        Activate(index);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::Activate(int index)
+{
+    TestEntry& entry = _tests[index];
+    if ( !entry.instance )
+        entry.instance = entry.create();
+
+    _currentTest = entry.instance;
+    _activeTest = index;
+    _pendingTest = -1;
+    _framesToMeasure = s_measuredFrames;
+
+    if ( _background )
+        Touch(index);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::Touch(int index)
+{
+    _prefetched.erase(std::remove(_prefetched.begin(), _prefetched.end(), index), _prefetched.end());
+    _warm.erase(std::remove(_warm.begin(), _warm.end(), index), _warm.end());
+    _warm.insert(_warm.begin(), index);
+
+    while ( (int)_warm.size() > _warmCapacity )
+    {
+        int victim = _warm.back();
+        _warm.pop_back();
+        Evict(victim);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::Evict(int index)
+{
+    TestEntry& entry = _tests[index];
+    if ( entry.instance && index != _activeTest )
+    {
+        entry.destroy(entry.instance);
+        entry.instance = nullptr;
+    }
+
+    _preparer->Release((unsigned int)index);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 void TestMenu::OnImGuiRender()
 {
-    for ( auto& test : _tests )
+    if ( ImGui::Checkbox("Prepare tests in the background", &_background) && !_background )
+    {
+        for ( int index : _warm )
+            Evict(index);
+        for ( int index : _prefetched )
+            _preparer->Release((unsigned int)index);
+        _warm.clear();
+        _prefetched.clear();
+        _pendingTest = -1;
+    }
+
+    if ( _background )
+    {
+        if ( ImGui::SliderInt("Warm tests", &_warmCapacity, 1, 8) && !_warm.empty() )
+            Touch(_warm.front());
+        ImGui::SliderFloat("Upload budget (ms)", &_uploadBudgetMs, 0.5f, 8.0f);
+    }
+
+    ImGui::Text("Worst switch frame, synchronous: %.1f ms (last %.1f)", _worstSwitchMs[0], _lastSwitchMs[0]);
+    ImGui::Text("Worst switch frame, background:  %.1f ms (last %.1f)", _worstSwitchMs[1], _lastSwitchMs[1]);
+    ImGui::Separator();
+
+    for ( int ii = 0; ii < (int)_tests.size(); ++ii )
     {
-        if (ImGui::Button(test.first.c_str()))
+        if ( ImGui::Button(_tests[ii].name.c_str()) )
+            RequestTest(ii);
+        else if ( _background && ImGui::IsItemHovered() && std::find(_warm.begin(), _warm.end(), ii) == _warm.end() &&
+                  std::find(_prefetched.begin(), _prefetched.end(), ii) == _prefetched.end() )
+            Prepare(ii);
+
+        if ( ii == _pendingTest )
+        {
+            ImGui::SameLine();
+            ImGui::TextDisabled("loading...");
+        }
+        else if ( _tests[ii].instance )
         {
-            _currentTest = test.second();
+            ImGui::SameLine();
+            ImGui::TextDisabled("warm");
         }
     }
 }
 
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestMenu::DestroyTest(Test* test)
+{
+    if ( test == this || _activeTest < 0 )
+        return;
+
+    BeginSwitchMeasurement();
+
+    // warm tests stay alive, Touch evicts them when they fall out of the cache
+    TestEntry& entry = _tests[_activeTest];
+    if ( !_background )
+    {
+        entry.destroy(test);
+        entry.instance = nullptr;
+    }
+
+    _activeTest = -1;
 }
 
+}
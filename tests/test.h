@@ -6,6 +6,13 @@
 #include <utility>
 #include <iostream>
 #include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "../allocators.h"
+
+struct SceneResources;
+class ScenePreparer;
 
 namespace test
 {
@@ -24,6 +31,27 @@ public:
     virtual void OnImGuiRender() {}
 };
 
+// -----------------------------------------------------------------------------
+// Detects a test that declares its resources with
+// static void DeclareResources(SceneResources&).
+// -----------------------------------------------------------------------------
+template <typename T, typename = void>
+struct HasResourceDeclaration : std::false_type
+{
+};
+
+template <typename T>
+struct HasResourceDeclaration<T, std::void_t<decltype(&T::DeclareResources)>> : std::true_type
+{
+};
+
+// -----------------------------------------------------------------------------
+// Lists the registered tests and switches between them. With background
+// preparation on, hovering or pressing a button loads the declared resources
+// of that test on worker threads, the switch happens once they are ready, and
+// tests left for the menu stay alive in a small LRU cache instead of being
+// destroyed so going back to them is instant.
+// -----------------------------------------------------------------------------
 class TestMenu : public Test
 {
 public:
@@ -31,19 +59,72 @@ public:
     TestMenu(Test*& currentTest);
     ~TestMenu();
 
+    // call every frame after ImGui::NewFrame, whichever test is current
+    void Update();
+
     virtual void OnImGuiRender() override;
 
     template <typename T>
     void RegisterTest(const std::string& name)
     {
         std::cout << "Restering test\n";
-        _tests.push_back(std::make_pair(name, [](){ return new T(); }));
+
+        // only one instance of a test is alive at a time, its storage is
+        // reserved up front instead of going through new on every switch
+        auto pool = std::make_shared<ObjectPool<T>>(1);
+        TestEntry entry;
+        entry.name    = name;
+        entry.create  = [pool]() -> Test* { return pool->Create(); };
+        entry.destroy = [pool](Test* test) { pool->Destroy(static_cast<T*>(test)); };
+        if constexpr ( HasResourceDeclaration<T>::value )
+            entry.declare = &T::DeclareResources;
+        _tests.push_back(std::move(entry));
     }
 
+    // called when leaving a test created by this menu, keeps it warm or
+    // returns it to its pool
+    void DestroyTest(Test* test);
+
 private:
 
-    Test*&      _currentTest;
-    std::vector<std::pair<std::string, std::function<Test*()>>> _tests;
+    struct TestEntry
+    {
+        std::string                 name;
+        std::function<Test*()>      create;
+        std::function<void(Test*)>  destroy;
+        void                        (*declare)(SceneResources&) = nullptr;
+        Test*                       instance = nullptr;     // alive while active or warm
+    };
+
+    void Prepare(int index);
+    void RequestTest(int index);
+    void Activate(int index);
+    void Touch(int index);
+    void Evict(int index);
+    void BeginSwitchMeasurement();
+
+    Test*&                  _currentTest;
+    std::vector<TestEntry>  _tests;
+    int                     _activeTest = -1;
+    int                     _pendingTest = -1;
+
+    std::unique_ptr<ScenePreparer>  _preparer;
+    std::vector<int>        _warm;                      // alive instances, most recently used first
+    std::vector<int>        _prefetched;                // prepared but never created, newest first
+    int                     _warmCapacity = 3;
+    bool                    _background = true;
+    float                   _uploadBudgetMs = 2.0f;
+
+    // worst frame from pressing a button until a few frames after the switch,
+    // [0] with synchronous construction and [1] with background preparation
+    static constexpr int    s_measuredFrames = 4;
+    static constexpr int    s_prefetchCapacity = 4;
+    bool                    _measuring = false;
+    bool                    _measuringBackground = false;
+    int                     _framesToMeasure = 0;
+    float                   _currentWorstMs = 0.0f;
+    float                   _lastSwitchMs[2] = {};
+    float                   _worstSwitchMs[2] = {};
 
 };
 
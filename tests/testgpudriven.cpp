@@ -0,0 +1,176 @@
+#include "testgpudriven.h"
+#include "../scenepreparer.h"
+#include "../renderer.h"
+#include <imgui.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace test
+{
+
+static const float s_worldWidth  = 2880.0f;
+static const float s_worldHeight = 1620.0f;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestGpuDriven::DeclareResources(SceneResources& resources)
+{
+    resources.shaders.push_back("res/shaders/color.shader");
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestGpuDriven::TestGpuDriven()
+    : _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+{
+    _shader = ResourceManager::Get().LoadShader("res/shaders/color.shader");
+    Build();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestGpuDriven::~TestGpuDriven()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestGpuDriven::Build()
+{
+    _meshes.clear();
+    _objects.clear();
+    _indirect.reset();
+
+    bool indirect = IndirectRenderer::IsSupported();
+    if ( indirect )
+        _indirect = std::make_unique<IndirectRenderer>();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // every object gets its own irregular polygon so no two meshes match
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    for ( int ii = 0; ii < _objectCount; ++ii )
+    {
+        int sides = 3 + (int)(unit(rng) * 22.0f);
+        positions.assign({ 0.0f, 0.0f });
+        indices.clear();
+        for ( int ss = 0; ss < sides; ++ss )
+        {
+            float angle  = 6.2831853f * ss / sides;
+            float radius = 0.6f + 0.4f * unit(rng);
+            positions.push_back(std::cos(angle) * radius);
+            positions.push_back(std::sin(angle) * radius);
+            indices.push_back(0);
+            indices.push_back(1 + ss);
+            indices.push_back(1 + (ss + 1) % sides);
+        }
+
+        Object object;
+        object.position = glm::vec3(unit(rng) * s_worldWidth, unit(rng) * s_worldHeight, 0.0f);
+        object.scale    = 4.0f + 8.0f * unit(rng);
+        object.color    = glm::vec4(unit(rng), unit(rng), unit(rng), 1.0f);
+        _objects.push_back(object);
+
+        Mesh mesh;
+        mesh.vao = std::make_unique<VertexArray>();
+        mesh.vbo = std::make_unique<VertexBuffer>(positions.data(), (unsigned int)(positions.size() * sizeof(float)));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        mesh.vao->AddBuffer(*mesh.vbo, layout);
+        mesh.ibo = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+        _meshes.push_back(std::move(mesh));
+
+        if ( indirect )
+        {
+            unsigned int meshIndex = _indirect->AddMesh(positions.data(), (unsigned int)positions.size() / 2,
+                                                        indices.data(), (unsigned int)indices.size());
+            _indirect->AddObject(meshIndex, object.position, object.scale, object.color);
+        }
+    }
+
+    if ( indirect )
+        _indirect->Build();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestGpuDriven::OnUpdate(float deltaTime)
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestGpuDriven::OnRender()
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    Renderer renderer;
+    glClearColor( 0.05f, 0.05f, 0.05f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glm::mat4 view = glm::scale(glm::mat4(1.0f), glm::vec3(_zoom, _zoom, 1.0f));
+    view = glm::translate(view, glm::vec3(-_camera.x, -_camera.y, 0.0f));
+    glm::mat4 viewProj = _projMat * view;
+
+    Mode mode = (Mode)_mode;
+    if ( mode != Mode::PerDraw && !_indirect )
+        mode = Mode::PerDraw;
+
+    auto start = Clock::now();
+    if ( mode == Mode::PerDraw )
+    {
+        _shader->Bind();
+        for ( size_t ii = 0; ii < _objects.size(); ++ii )
+        {
+            const Object& object = _objects[ii];
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), object.position);
+            model = glm::scale(model, glm::vec3(object.scale, object.scale, 1.0f));
+
+            _shader->SetUniformMat4f("u_MVP", viewProj * model);
+            _shader->SetUniform4f("u_Color", object.color.x, object.color.y, object.color.z, object.color.w);
+            renderer.Draw(*_meshes[ii].vao, *_meshes[ii].ibo, *_shader);
+        }
+    }
+    else
+    {
+        _indirect->SetComputeCulling(mode == Mode::IndirectGpuCulling);
+        _indirect->Draw(viewProj);
+    }
+
+    // exponential moving average so the number is readable
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    _submitMs = _submitMs * 0.95 + ms * 0.05;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestGpuDriven::OnImGuiRender()
+{
+    if ( !_indirect )
+        ImGui::Text("Multi draw indirect with storage buffers is not supported, per draw path only");
+
+    ImGui::RadioButton("Per draw", &_mode, (int)Mode::PerDraw);
+    ImGui::RadioButton("Indirect, CPU culling", &_mode, (int)Mode::IndirectCpuCulling);
+    if ( IndirectRenderer::IsComputeCullingSupported() )
+        ImGui::RadioButton("Indirect, compute culling", &_mode, (int)Mode::IndirectGpuCulling);
+    else if ( _mode == (int)Mode::IndirectGpuCulling )
+        _mode = (int)Mode::IndirectCpuCulling;
+
+    ImGui::SliderFloat2("Camera", &_camera.x, 0.0f, s_worldWidth);
+    ImGui::SliderFloat("Zoom", &_zoom, 0.25f, 4.0f);
+
+    ImGui::SliderInt("Meshes", &_objectCount, 1000, 100000);
+    if ( ImGui::Button("Rebuild") )
+        Build();
+
+    ImGui::Text("%zu distinct meshes", _meshes.size());
+    ImGui::Text("CPU submission: %.3f ms", _submitMs);
+    if ( _indirect && _mode == (int)Mode::IndirectCpuCulling )
+        ImGui::Text("Visible after CPU culling: %u", _indirect->GetVisibleCount());
+}
+
+}
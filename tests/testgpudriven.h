@@ -0,0 +1,80 @@
+#ifndef _testgpudriven_h_
+#define _testgpudriven_h_
+
+#include "test.h"
+#include "../vertexarray.h"
+#include "../vertexbufferlayout.h"
+#include "../vertexbuffer.h"
+#include "../indexbuffer.h"
+#include "../shader.h"
+#include "../indirectrenderer.h"
+#include "../resourcemanager.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Tens of thousands of distinct meshes drawn either one Renderer::Draw per
+// mesh or through the IndirectRenderer with a single multi draw.
+// -----------------------------------------------------------------------------
+class TestGpuDriven : public Test
+{
+public:
+
+    TestGpuDriven();
+    ~TestGpuDriven();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+    static void DeclareResources(SceneResources& resources);
+
+private:
+
+    enum class Mode
+    {
+        PerDraw = 0,
+        IndirectCpuCulling,
+        IndirectGpuCulling
+    };
+
+    void Build();
+
+    struct Mesh
+    {
+        std::unique_ptr<VertexArray>    vao;
+        std::unique_ptr<VertexBuffer>   vbo;
+        std::unique_ptr<IndexBuffer>    ibo;
+    };
+
+    struct Object
+    {
+        glm::vec3   position;
+        float       scale;
+        glm::vec4   color;
+    };
+
+    std::vector<Mesh>                   _meshes;
+    std::vector<Object>                 _objects;
+    ResourceRef<Shader>                 _shader;
+    std::unique_ptr<IndirectRenderer>   _indirect;
+
+    glm::mat4                           _projMat;
+    glm::vec2                           _camera     = glm::vec2(0.0f, 0.0f);
+    float                               _zoom       = 1.0f;
+
+    int                                 _objectCount = 20000;
+    int                                 _mode        = (int)Mode::PerDraw;
+    double                              _submitMs    = 0.0;
+};
+
+}
+
+#endif // _testgpudriven_h_
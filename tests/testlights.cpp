@@ -0,0 +1,296 @@
+#include "testlights.h"
+#include "../renderer.h"
+#include "../scenepreparer.h"
+#include <imgui.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace test
+{
+
+static const unsigned int   s_counts[]      = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+static const char*          s_countNames[]  = { "16", "32", "64", "128", "256", "512", "1024", "2048", "4096" };
+static const int            s_countCount    = sizeof(s_counts) / sizeof(s_counts[0]);
+
+static const unsigned int   s_tileSizes[]   = { 16, 32, 64 };
+static const char*          s_tileNames[]   = { "16", "32", "64" };
+
+static const float          s_benchDelta    = 1.0f / 60.0f;
+static const unsigned int   s_benchWarmup   = 30;
+static const unsigned int   s_benchMeasure  = 60;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestLights::DeclareResources(SceneResources& resources)
+{
+    resources.shaders.push_back("res/shaders/lit.shader");
+    resources.textures.push_back("res/textures/sample.jpg");
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestLights::TestLights()
+    : _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+{
+    float positions[] = {   0.0f,   0.0f, 0.0f, 0.0f,
+                          960.0f,   0.0f, 1.0f, 0.0f,
+                          960.0f, 540.0f, 1.0f, 1.0f,
+                            0.0f, 540.0f, 0.0f, 1.0f };
+
+    unsigned int indices[] = { 0, 1, 2,
+                               2, 3, 0 };
+
+    ResourceManager& resources = ResourceManager::Get();
+    _vbo = resources.LoadVertexBuffer(positions, 4 * 4 * sizeof(float));
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    _vao = resources.LoadVertexArray(_vbo, layout);
+
+    _ibo = resources.LoadIndexBuffer(indices, 6);
+
+    _shader = resources.LoadShader("res/shaders/lit.shader");
+    _texture = resources.LoadTexture("res/textures/sample.jpg");
+
+    _grid = std::make_unique<LightGrid>(s_tileSizes[_tileSizeIndex]);
+
+    glGenQueries(s_queryCount, _queries);
+    Respawn();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestLights::~TestLights()
+{
+    glDeleteQueries(s_queryCount, _queries);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestLights::Respawn()
+{
+    // the same lights for a given count, so benchmark runs are comparable
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    unsigned int count = s_counts[_countIndex];
+    _lights.Clear();
+    _lights.Reserve(count);
+    _orbits.clear();
+    _orbits.reserve(count);
+
+    for ( unsigned int ii = 0; ii < count; ++ii )
+    {
+        Orbit orbit;
+        orbit.centre = glm::vec2(unit(rng) * 960.0f, unit(rng) * 540.0f);
+        orbit.radius = 10.0f + unit(rng) * 60.0f;
+        orbit.speed = (unit(rng) - 0.5f) * 4.0f;
+        orbit.phase = unit(rng) * 6.2831853f;
+        _orbits.push_back(orbit);
+
+        // dimmer as the count goes up so the scene does not saturate
+        glm::vec3 color(unit(rng), unit(rng), unit(rng));
+        color *= 2.0f / (glm::length(color) + 0.1f) * std::sqrt(16.0f / count);
+        float radius = _lightRadius * (0.5f + unit(rng));
+        _lights.Add(orbit.centre, radius, color);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestLights::ReadQueries()
+{
+    unsigned int index = _frame % s_queryCount;
+    if ( !_queryIssued[index] )
+        return;
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(_queries[index], GL_QUERY_RESULT, &nanoseconds);
+    double ms = nanoseconds * 1e-6;
+    _gpuMs += (ms - _gpuMs) * 0.05;
+
+    if ( _queryMeasured[index] )
+    {
+        _benchGpuSum += ms;
+        ++_benchGpuCount;
+    }
+
+    _queryIssued[index] = false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestLights::OnUpdate(float deltaTime)
+{
+    _time += _benchmarking ? s_benchDelta : deltaTime;
+
+    for ( size_t ii = 0; ii < _orbits.size(); ++ii )
+    {
+        const Orbit& orbit = _orbits[ii];
+        float angle = orbit.phase + orbit.speed * _time;
+        _lights.SetPosition(ii, orbit.centre + orbit.radius * glm::vec2(std::cos(angle), std::sin(angle)));
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestLights::OnRender()
+{
+    glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    ReadQueries();
+
+    // bins against the viewport bound now, which follows the render scale
+    _grid->SetTileSize(s_tileSizes[_tileSizeIndex]);
+    _grid->Build(_lights, _projMat, _mode != Mode::BruteForce);
+
+    const LightGrid::Stats& stats = _grid->GetStats();
+    _binMs += (stats.binMs - _binMs) * 0.05;
+    _uploadMs += (stats.uploadMs - _uploadMs) * 0.05;
+
+    unsigned int index = _frame % s_queryCount;
+    bool measured = _benchmarking && _benchFrame >= s_benchWarmup;
+
+    _texture->Bind(0);
+    _grid->Bind(*_shader, 1);
+    _shader->SetUniform1i("u_Texture", 0);
+    _shader->SetUniformMat4f("u_MVP", _projMat);
+    _shader->SetUniform1i("u_Mode", (int)_mode);
+    _shader->SetUniform1f("u_HeatMax", 32.0f);
+    _shader->SetUniform4f("u_Ambient", 0.08f, 0.08f, 0.1f, 1.0f);
+
+    Renderer renderer;
+    glBeginQuery(GL_TIME_ELAPSED, _queries[index]);
+    renderer.Draw(*_vao, *_ibo, *_shader);
+    glEndQuery(GL_TIME_ELAPSED);
+
+    _queryIssued[index] = true;
+    _queryMeasured[index] = measured;
+    ++_frame;
+
+    if ( measured )
+    {
+        _benchBinSum += stats.binMs;
+        _benchMaxPerTile = std::max(_benchMaxPerTile, stats.maxPerTile);
+    }
+
+    if ( _benchmarking )
+        AdvanceBenchmark();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestLights::AdvanceBenchmark()
+{
+    if ( ++_benchFrame < s_benchWarmup + s_benchMeasure + s_queryCount )
+        return;
+
+    // the extra frames let the last measured queries come back
+    if ( _benchGpuCount > 0 )
+    {
+        _results.push_back({ s_counts[_countIndex], _mode, _benchGpuSum / _benchGpuCount,
+                             _benchBinSum / s_benchMeasure, _benchMaxPerTile });
+    }
+
+    _benchFrame = 0;
+    _benchGpuSum = _benchBinSum = 0.0;
+    _benchGpuCount = 0;
+    _benchMaxPerTile = 0;
+
+    // brute force then tiled for every count
+    ++_benchConfig;
+    if ( _benchConfig >= s_countCount * 2 )
+    {
+        _benchmarking = false;
+        _mode = Mode::Tiled;
+        return;
+    }
+
+    _mode = _benchConfig % 2 ? Mode::Tiled : Mode::BruteForce;
+    if ( (int)(_benchConfig / 2) != _countIndex )
+    {
+        _countIndex = (int)(_benchConfig / 2);
+        Respawn();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestLights::OnImGuiRender()
+{
+    static const char* modes[] = { "Tiled", "Brute force", "Lights per tile" };
+
+    if ( !_benchmarking )
+    {
+        int mode = (int)_mode;
+        if ( ImGui::Combo("Lighting", &mode, modes, (int)Mode::Count) )
+            _mode = (Mode)mode;
+
+        bool respawn = ImGui::Combo("Lights", &_countIndex, s_countNames, s_countCount);
+        respawn |= ImGui::SliderFloat("Light radius", &_lightRadius, 8.0f, 160.0f);
+        if ( respawn )
+            Respawn();
+
+        ImGui::Combo("Tile size", &_tileSizeIndex, s_tileNames, 3);
+
+        bool simd = _grid->IsSimd();
+        if ( LightGrid::IsSimdSupported() && ImGui::Checkbox("SSE binning", &simd) )
+            _grid->SetSimd(simd);
+
+        if ( ImGui::Button("Run benchmark") )
+        {
+            _results.clear();
+            _benchmarking = true;
+            _benchConfig = 0;
+            _benchFrame = 0;
+            _countIndex = 0;
+            _mode = Mode::BruteForce;
+            Respawn();
+        }
+    }
+    else
+    {
+        ImGui::Text("Benchmarking %s, %s lights...", modes[(int)_mode], s_countNames[_countIndex]);
+    }
+
+    const LightGrid::Stats& stats = _grid->GetStats();
+    ImGui::Separator();
+    ImGui::Text("Lit draw: GPU %.3f ms", _gpuMs);
+    ImGui::Text("Binning: CPU %.3f ms, upload %.3f ms", _binMs, _uploadMs);
+    ImGui::Text("%ux%u tiles, %u indices, at most %u lights in a tile", stats.tilesX, stats.tilesY, stats.indices,
+                stats.maxPerTile);
+
+    if ( !_results.empty() )
+    {
+        ImGui::Separator();
+        ImGui::Columns(5, "results");
+        ImGui::Text("Lighting");        ImGui::NextColumn();
+        ImGui::Text("Lights");          ImGui::NextColumn();
+        ImGui::Text("GPU ms");          ImGui::NextColumn();
+        ImGui::Text("CPU bin ms");      ImGui::NextColumn();
+        ImGui::Text("Max per tile");    ImGui::NextColumn();
+        ImGui::Separator();
+        for ( const Result& result : _results )
+        {
+            bool tiled = result.mode == Mode::Tiled;
+            ImGui::Text("%s", tiled ? "tiled" : "brute force");    ImGui::NextColumn();
+            ImGui::Text("%u", result.lights);                       ImGui::NextColumn();
+            ImGui::Text("%.3f", result.gpuMs);                      ImGui::NextColumn();
+            ImGui::Text("%.3f", result.binMs);                      ImGui::NextColumn();
+            if ( tiled )
+                ImGui::Text("%u", result.maxPerTile);
+            else
+                ImGui::TextDisabled("-");
+            ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+    }
+}
+
+}
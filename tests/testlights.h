@@ -0,0 +1,112 @@
+#ifndef _testlights_h_
+#define _testlights_h_
+
+#include "test.h"
+#include "../vertexarray.h"
+#include "../vertexbufferlayout.h"
+#include "../vertexbuffer.h"
+#include "../indexbuffer.h"
+#include "../shader.h"
+#include "../texture.h"
+#include "../resourcemanager.h"
+#include "../lightgrid.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Lights a full screen textured quad with up to 4096 moving point lights,
+// either looping over every light per fragment or over the lights binned into
+// the fragment's screen tile. The benchmark sweeps 16 to 4096 lights with both
+// and reports the GPU time of the lit draw and the CPU time of the binning.
+// -----------------------------------------------------------------------------
+class TestLights : public Test
+{
+public:
+
+    TestLights();
+    ~TestLights();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+    static void DeclareResources(SceneResources& resources);
+
+private:
+
+    enum class Mode
+    {
+        Tiled,
+        BruteForce,
+        TileHeatMap,
+        Count
+    };
+
+    void Respawn();
+    void ReadQueries();
+    void AdvanceBenchmark();
+
+    struct Orbit
+    {
+        glm::vec2   centre;
+        float       radius;
+        float       speed;
+        float       phase;
+    };
+
+    struct Result
+    {
+        unsigned int    lights;
+        Mode            mode;
+        double          gpuMs;
+        double          binMs;
+        unsigned int    maxPerTile;
+    };
+
+    ResourceRef<VertexArray>        _vao;
+    ResourceRef<VertexBuffer>       _vbo;
+    ResourceRef<IndexBuffer>        _ibo;
+    ResourceRef<Shader>             _shader;
+    ResourceRef<Texture>            _texture;
+    std::unique_ptr<LightGrid>      _grid;
+
+    LightSoA                        _lights;
+    std::vector<Orbit>              _orbits;
+    glm::mat4                       _projMat;
+
+    Mode                            _mode           = Mode::Tiled;
+    int                             _countIndex     = 4;
+    int                             _tileSizeIndex  = 1;
+    float                           _lightRadius    = 40.0f;
+    float                           _time           = 0.0f;
+
+    // GL_TIME_ELAPSED of the lit draw, read a few frames late
+    static constexpr unsigned int   s_queryCount    = 4;
+    unsigned int                    _queries[s_queryCount]      = {};
+    bool                            _queryIssued[s_queryCount]  = {};
+    bool                            _queryMeasured[s_queryCount] = {};
+    unsigned int                    _frame          = 0;
+    double                          _gpuMs          = 0.0;
+    double                          _binMs          = 0.0;
+    double                          _uploadMs       = 0.0;
+
+    // benchmark state
+    bool                            _benchmarking   = false;
+    unsigned int                    _benchConfig    = 0;
+    unsigned int                    _benchFrame     = 0;
+    double                          _benchGpuSum    = 0.0;
+    double                          _benchBinSum    = 0.0;
+    unsigned int                    _benchGpuCount  = 0;
+    unsigned int                    _benchMaxPerTile = 0;
+    std::vector<Result>             _results;
+};
+
+}
+
+#endif // _testlights_h_
@@ -0,0 +1,173 @@
+#include "testoverdraw.h"
+#include "../scenepreparer.h"
+#include "../renderer.h"
+#include "../vertexbufferlayout.h"
+#include <imgui.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <random>
+
+namespace test
+{
+
+// materials, in the order they are created
+enum
+{
+    s_opaquePhoto,
+    s_maskedRing,
+    s_translucentPhoto,
+    s_translucentGlow,
+    s_materialCount
+};
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestOverdraw::DeclareResources(SceneResources& resources)
+{
+    resources.shaders.push_back("res/shaders/material.shader");
+    resources.textures.push_back("res/textures/sample.jpg");
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestOverdraw::TestOverdraw()
+    : _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+{
+    float positions[] = { -0.5f, -0.5f, 0.0f, 0.0f,
+                           0.5f, -0.5f, 1.0f, 0.0f,
+                           0.5f,  0.5f, 1.0f, 1.0f,
+                          -0.5f,  0.5f, 0.0f, 1.0f };
+
+    unsigned int indices[] = { 0, 1, 2,
+                               2, 3, 0 };
+
+    _vbo = std::make_unique<VertexBuffer>(positions, (unsigned int)sizeof(positions));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    _vao = std::make_unique<VertexArray>();
+    _vao->AddBuffer(*_vbo, layout);
+    _ibo = std::make_unique<IndexBuffer>(indices, 6);
+
+    _shader = ResourceManager::Get().LoadShader("res/shaders/material.shader");
+
+    // a hard edged ring, cut out by the alpha test, and a soft glow
+    const int size = 64;
+    std::vector<unsigned char> ring((size_t)size * size * 4u), glow((size_t)size * size * 4u);
+    for ( int y = 0; y < size; ++y )
+    {
+        for ( int x = 0; x < size; ++x )
+        {
+            float dx = (x + 0.5f) / size - 0.5f, dy = (y + 0.5f) / size - 0.5f;
+            float r = std::sqrt(dx * dx + dy * dy) * 2.0f;
+            unsigned char* texel = &ring[((size_t)y * size + x) * 4u];
+            texel[0] = 230; texel[1] = 180; texel[2] = 60;
+            texel[3] = (r > 0.5f && r < 0.95f) ? 255 : 0;
+
+            texel = &glow[((size_t)y * size + x) * 4u];
+            texel[0] = 80; texel[1] = 160; texel[2] = 255;
+            texel[3] = (unsigned char)(255.0f * std::fmax(0.0f, 1.0f - r));
+        }
+    }
+
+    _photo = ResourceManager::Get().LoadTexture("res/textures/sample.jpg");
+    _textures.push_back(std::make_unique<Texture>(size, size, ring.data()));
+    _textures.push_back(std::make_unique<Texture>(size, size, glow.data()));
+
+    _materials.resize(s_materialCount);
+    _materials[s_opaquePhoto] = std::make_unique<Material>(*_shader, *_photo);
+    _materials[s_maskedRing] = std::make_unique<Material>(*_shader, *_textures[0]);
+    _materials[s_translucentPhoto] = std::make_unique<Material>(*_shader, *_photo, glm::vec4(1.0f, 1.0f, 1.0f, 0.5f));
+    _materials[s_translucentGlow] = std::make_unique<Material>(*_shader, *_textures[1]);
+
+    _queue = std::make_unique<RenderQueue>();
+    glGenQueries(s_queryCount, _queries);
+
+    Scatter();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestOverdraw::~TestOverdraw()
+{
+    glDeleteQueries(s_queryCount, _queries);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestOverdraw::Scatter()
+{
+    // fixed seed so both pass modes see the same scene
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    _sprites.resize(_spriteCount);
+    for ( Sprite& sprite : _sprites )
+    {
+        glm::vec3 position(unit(rng) * 960.0f, unit(rng) * 540.0f, unit(rng) * 1.8f - 0.9f);
+        float scale = _spriteSize * (0.5f + unit(rng));
+
+        sprite.model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(scale, scale, 1.0f));
+
+        if ( unit(rng) < _translucentShare )
+            sprite.material = unit(rng) < 0.5f ? s_translucentPhoto : s_translucentGlow;
+        else
+            sprite.material = unit(rng) < 0.7f ? s_opaquePhoto : s_maskedRing;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestOverdraw::OnUpdate(float deltaTime)
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestOverdraw::OnRender()
+{
+    glClearColor( 0.05f, 0.05f, 0.05f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    unsigned int index = _frame % s_queryCount;
+    if ( _queryIssued[index] )
+    {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(_queries[index], GL_QUERY_RESULT, &nanoseconds);
+        _gpuMs += (nanoseconds * 1e-6 - _gpuMs) * 0.05;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, _queries[index]);
+    for ( const Sprite& sprite : _sprites )
+        _queue->Submit(*_vao, *_ibo, *_materials[sprite.material], sprite.model);
+    _queue->Flush(_projMat);
+    glEndQuery(GL_TIME_ELAPSED);
+
+    _queryIssued[index] = true;
+    ++_frame;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestOverdraw::OnImGuiRender()
+{
+    bool changed = ImGui::SliderInt("Sprites", &_spriteCount, 100, 20000);
+    changed |= ImGui::SliderFloat("Translucent share", &_translucentShare, 0.0f, 1.0f);
+    changed |= ImGui::SliderFloat("Sprite size", &_spriteSize, 16.0f, 400.0f);
+    if ( changed )
+        Scatter();
+
+    ImGui::Separator();
+    _queue->OnImGuiRender();
+
+    if ( ImGui::GetTime() - _lastSampleTime >= 0.5 )
+    {
+        _shownGpuMs = _gpuMs;
+        _lastSampleTime = ImGui::GetTime();
+    }
+    ImGui::Text("Scene GPU time: %.3f ms", _shownGpuMs);
+}
+
+}
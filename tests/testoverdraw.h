@@ -0,0 +1,76 @@
+#ifndef _testoverdraw_h_
+#define _testoverdraw_h_
+
+#include "test.h"
+#include "../vertexarray.h"
+#include "../vertexbuffer.h"
+#include "../indexbuffer.h"
+#include "../shader.h"
+#include "../texture.h"
+#include "../material.h"
+#include "../renderqueue.h"
+#include "../resourcemanager.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Thousands of large overlapping sprites, most of them opaque or alpha
+// tested, drawn through the render queue with either everything blended or
+// the opaque / translucent pass split.
+// -----------------------------------------------------------------------------
+class TestOverdraw : public Test
+{
+public:
+
+    TestOverdraw();
+    ~TestOverdraw();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+    static void DeclareResources(SceneResources& resources);
+
+private:
+
+    void Scatter();
+
+    struct Sprite
+    {
+        glm::mat4       model;
+        unsigned int    material;
+    };
+
+    ResourceRef<Shader>                     _shader;
+    std::unique_ptr<VertexArray>            _vao;
+    std::unique_ptr<VertexBuffer>           _vbo;
+    std::unique_ptr<IndexBuffer>            _ibo;
+    ResourceRef<Texture>                    _photo;
+    std::vector<std::unique_ptr<Texture>>   _textures;      // generated
+    std::vector<std::unique_ptr<Material>>  _materials;
+    std::unique_ptr<RenderQueue>            _queue;
+
+    std::vector<Sprite>                     _sprites;
+    glm::mat4                               _projMat;
+    int                                     _spriteCount        = 2000;
+    float                                   _translucentShare   = 0.2f;
+    float                                   _spriteSize         = 160.0f;
+
+    static constexpr unsigned int           s_queryCount        = 4;
+    unsigned int                            _queries[s_queryCount]      = {};
+    bool                                    _queryIssued[s_queryCount]  = {};
+    unsigned int                            _frame              = 0;
+    double                                  _gpuMs              = 0.0;
+    double                                  _shownGpuMs         = 0.0;
+    double                                  _lastSampleTime     = 0.0;
+};
+
+}
+
+#endif // _testoverdraw_h_
@@ -0,0 +1,208 @@
+#include "testparticles.h"
+#include "../renderer.h"
+#include <imgui.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cmath>
+
+namespace test
+{
+
+static const unsigned int   s_counts[]      = { 10000, 100000, 250000, 500000, 1000000, 2000000, 4000000 };
+static const char*          s_countNames[]  = { "10k", "100k", "250k", "500k", "1M", "2M", "4M" };
+static const int            s_countCount    = sizeof(s_counts) / sizeof(s_counts[0]);
+
+// the pool needs the longest lifetime to fill before it is measured
+static const float          s_benchDelta    = 1.0f / 60.0f;
+static const unsigned int   s_benchWarmup   = 180;
+static const unsigned int   s_benchMeasure  = 60;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestParticles::TestParticles()
+    : _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+{
+    glGenQueries(s_queryCount, _queries);
+    Recreate();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestParticles::~TestParticles()
+{
+    glDeleteQueries(s_queryCount, _queries);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestParticles::Recreate()
+{
+    _system.reset();
+    _system = std::make_unique<ParticleSystem>(s_counts[_countIndex], (ParticleSystem::Backend)_backend);
+    _backend = (int)_system->GetBackend();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestParticles::ReadQueries()
+{
+    unsigned int index = _frame % s_queryCount;
+    if ( !_queryIssued[index] )
+        return;
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(_queries[index], GL_QUERY_RESULT, &nanoseconds);
+    double ms = nanoseconds * 1e-6;
+    _gpuMs += (ms - _gpuMs) * 0.05;
+
+    if ( _queryMeasured[index] )
+    {
+        _benchGpuSum += ms;
+        ++_benchGpuCount;
+    }
+
+    _queryIssued[index] = false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestParticles::OnUpdate(float deltaTime)
+{
+    _deltaTime = _benchmarking ? s_benchDelta : deltaTime;
+    _time += _deltaTime;
+
+    ParticleSystem::Settings& settings = _system->GetSettings();
+    settings.emitter = glm::vec2(480.0f + 300.0f * std::sin(_time * 0.7f), 100.0f);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestParticles::OnRender()
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    glClearColor( 0.02f, 0.02f, 0.04f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    ReadQueries();
+
+    unsigned int index = _frame % s_queryCount;
+    bool measured = _benchmarking && _benchFrame >= s_benchWarmup;
+
+    auto start = Clock::now();
+    glBeginQuery(GL_TIME_ELAPSED, _queries[index]);
+    _system->Update(_deltaTime);
+    _system->Draw(_projMat);
+    glEndQuery(GL_TIME_ELAPSED);
+    double cpuMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    _queryIssued[index] = true;
+    _queryMeasured[index] = measured;
+    _cpuMs += (cpuMs - _cpuMs) * 0.05;
+    ++_frame;
+
+    if ( measured )
+        _benchCpuSum += cpuMs;
+
+    if ( _benchmarking )
+        AdvanceBenchmark();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestParticles::AdvanceBenchmark()
+{
+    if ( ++_benchFrame < s_benchWarmup + s_benchMeasure + s_queryCount )
+        return;
+
+    // the extra frames let the last measured queries come back
+    if ( _benchGpuCount > 0 )
+    {
+        _results.push_back({ s_counts[_countIndex], _system->GetBackend(), _benchGpuSum / _benchGpuCount,
+                             _benchCpuSum / s_benchMeasure });
+    }
+
+    _benchFrame = 0;
+    _benchGpuSum = _benchCpuSum = 0.0;
+    _benchGpuCount = 0;
+
+    // every count on transform feedback, then on compute when available
+    ++_benchConfig;
+    unsigned int backends = ParticleSystem::IsComputeSupported() ? 2 : 1;
+    if ( _benchConfig >= s_countCount * backends )
+    {
+        _benchmarking = false;
+        return;
+    }
+
+    _countIndex = (int)(_benchConfig % s_countCount);
+    _backend = (int)(_benchConfig / s_countCount);
+    Recreate();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestParticles::OnImGuiRender()
+{
+    static const char* backends[] = { "Transform feedback (GL 3.3)", "Compute (GL 4.3)" };
+
+    if ( !ParticleSystem::IsComputeSupported() )
+        ImGui::TextDisabled("Compute shaders not available, transform feedback only");
+
+    if ( !_benchmarking )
+    {
+        bool changed = ImGui::Combo("Backend", &_backend, backends, ParticleSystem::IsComputeSupported() ? 2 : 1);
+        changed |= ImGui::Combo("Particles", &_countIndex, s_countNames, s_countCount);
+        if ( changed )
+            Recreate();
+
+        ParticleSystem::Settings& settings = _system->GetSettings();
+        ImGui::SliderFloat("Size", &settings.size, 0.5f, 8.0f);
+        ImGui::SliderFloat("Spread", &settings.spread, 0.0f, 6.28f);
+
+        if ( ImGui::Button("Run benchmark") )
+        {
+            _results.clear();
+            _benchmarking = true;
+            _benchConfig = 0;
+            _benchFrame = 0;
+            _countIndex = 0;
+            _backend = 0;
+            Recreate();
+        }
+    }
+    else
+    {
+        ImGui::Text("Benchmarking %s, %s particles...", backends[_backend], s_countNames[_countIndex]);
+    }
+
+    if ( !_system->IsValid() )
+        ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Particle shaders failed to build");
+
+    ImGui::Separator();
+    ImGui::Text("Update + draw: GPU %.3f ms, CPU %.3f ms", _gpuMs, _cpuMs);
+
+    if ( !_results.empty() )
+    {
+        ImGui::Separator();
+        ImGui::Columns(4, "results");
+        ImGui::Text("Backend");         ImGui::NextColumn();
+        ImGui::Text("Particles");       ImGui::NextColumn();
+        ImGui::Text("GPU ms");          ImGui::NextColumn();
+        ImGui::Text("CPU submit ms");   ImGui::NextColumn();
+        ImGui::Separator();
+        for ( const Result& result : _results )
+        {
+            bool compute = result.backend == ParticleSystem::Backend::Compute;
+            ImGui::Text("%s", compute ? "compute" : "feedback");   ImGui::NextColumn();
+            ImGui::Text("%u", result.count);                         ImGui::NextColumn();
+            ImGui::Text("%.3f", result.gpuMs);                       ImGui::NextColumn();
+            ImGui::Text("%.3f", result.cpuMs);                       ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+    }
+}
+
+}
@@ -0,0 +1,74 @@
+#ifndef _testparticles_h_
+#define _testparticles_h_
+
+#include "test.h"
+#include "../particlesystem.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Runs the GPU particle system and times it. The benchmark sweeps particle
+// counts from 10k to 4M for every available backend and reports the GPU time
+// of simulation plus drawing once the pool has filled up.
+// -----------------------------------------------------------------------------
+class TestParticles : public Test
+{
+public:
+
+    TestParticles();
+    ~TestParticles();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+private:
+
+    void Recreate();
+    void ReadQueries();
+    void AdvanceBenchmark();
+
+    struct Result
+    {
+        unsigned int                count;
+        ParticleSystem::Backend     backend;
+        double                      gpuMs;
+        double                      cpuMs;
+    };
+
+    std::unique_ptr<ParticleSystem> _system;
+    glm::mat4                       _projMat;
+
+    int                             _countIndex     = 2;
+    int                             _backend        = 0;
+    float                           _time           = 0.0f;
+    float                           _deltaTime      = 0.0f;
+
+    // GL_TIME_ELAPSED, read a few frames late
+    static constexpr unsigned int   s_queryCount    = 4;
+    unsigned int                    _queries[s_queryCount]      = {};
+    bool                            _queryIssued[s_queryCount]  = {};
+    bool                            _queryMeasured[s_queryCount] = {};
+    unsigned int                    _frame          = 0;
+    double                          _gpuMs          = 0.0;
+    double                          _cpuMs          = 0.0;
+
+    // benchmark state
+    bool                            _benchmarking   = false;
+    unsigned int                    _benchConfig    = 0;
+    unsigned int                    _benchFrame     = 0;
+    double                          _benchGpuSum    = 0.0;
+    double                          _benchCpuSum    = 0.0;
+    unsigned int                    _benchGpuCount  = 0;
+    std::vector<Result>             _results;
+};
+
+}
+
+#endif // _testparticles_h_
@@ -0,0 +1,232 @@
+#include "teststaticbatch.h"
+#include "../scenepreparer.h"
+#include "../renderer.h"
+#include "../vertexbufferlayout.h"
+#include <imgui.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace test
+{
+
+static const int            s_mapSize           = 1000;
+static const int            s_atlasTiles        = 4;        // per side
+static const int            s_atlasTileSize     = 16;
+static const float          s_chunkSize         = 32.0f;
+static const unsigned int   s_immediateQuads    = 1u << 16;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestStaticBatch::DeclareResources(SceneResources& resources)
+{
+    resources.shaders.push_back("res/shaders/sprite.shader");
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestStaticBatch::TestStaticBatch()
+    : _rng(2024),
+      _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+      _center(s_mapSize * 0.5f, s_mapSize * 0.5f)
+{
+    _shader = ResourceManager::Get().LoadShader("res/shaders/sprite.shader");
+    _shader->Bind();
+    _shader->SetUniform1i("u_Texture", 0);
+
+    // a tile palette with dark borders
+    int atlasSize = s_atlasTiles * s_atlasTileSize;
+    std::vector<unsigned char> pixels((size_t)atlasSize * atlasSize * 4u);
+    for ( int yy = 0; yy < atlasSize; ++yy )
+    {
+        for ( int xx = 0; xx < atlasSize; ++xx )
+        {
+            int type = (yy / s_atlasTileSize) * s_atlasTiles + xx / s_atlasTileSize;
+            int tx = xx % s_atlasTileSize, ty = yy % s_atlasTileSize;
+            bool border = tx == 0 || ty == 0 || tx == s_atlasTileSize - 1 || ty == s_atlasTileSize - 1;
+            unsigned char* p = &pixels[((size_t)yy * atlasSize + xx) * 4u];
+            p[0] = border ? 20 : (unsigned char)(60 + 50 * (type % 4));
+            p[1] = border ? 20 : (unsigned char)(60 + 50 * (type / 4));
+            p[2] = border ? 20 : (unsigned char)(200 - 40 * (type % 3));
+            p[3] = 255;
+        }
+    }
+    _atlas = std::make_unique<Texture>(atlasSize, atlasSize, pixels.data());
+
+    std::uniform_int_distribution<int> type(0, s_atlasTiles * s_atlasTiles - 1);
+    _tiles.resize((size_t)s_mapSize * s_mapSize);
+    _ids.resize(_tiles.size());
+
+    _batch = std::make_unique<StaticBatch>(s_chunkSize, (unsigned int)(s_chunkSize * s_chunkSize));
+    for ( int yy = 0; yy < s_mapSize; ++yy )
+    {
+        for ( int xx = 0; xx < s_mapSize; ++xx )
+        {
+            size_t index = (size_t)yy * s_mapSize + xx;
+            _tiles[index] = (uint8_t)type(_rng);
+            _ids[index] = _batch->Add(glm::vec2((float)xx, (float)yy), glm::vec2(1.0f), GetTileUV(_tiles[index]));
+        }
+    }
+    _batch->Update();
+
+    _vao = std::make_unique<VertexArray>();
+    _vbo = std::make_unique<VertexBuffer>(nullptr, s_immediateQuads * 4u * (unsigned int)sizeof(StaticBatch::Vertex),
+                                          GL_STREAM_DRAW);
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<unsigned short>(2);
+    layout.Push<unsigned char>(4);
+    _vao->AddBuffer(*_vbo, layout);
+
+    std::vector<unsigned int> indices((size_t)s_immediateQuads * 6u);
+    for ( unsigned int qq = 0; qq < s_immediateQuads; ++qq )
+    {
+        unsigned int base = qq * 4u;
+        unsigned int quad[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+        std::copy(quad, quad + 6, &indices[(size_t)qq * 6u]);
+    }
+    _ibo = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+    _vertices.reserve((size_t)s_immediateQuads * 4u);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestStaticBatch::~TestStaticBatch()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+glm::vec4 TestStaticBatch::GetTileUV(uint8_t type) const
+{
+    // half a texel in so bilinear filtering stays inside the tile
+    float atlasSize = (float)(s_atlasTiles * s_atlasTileSize);
+    float x = (float)((type % s_atlasTiles) * s_atlasTileSize), y = (float)((type / s_atlasTiles) * s_atlasTileSize);
+    return glm::vec4((x + 0.5f) / atlasSize, (y + 0.5f) / atlasSize,
+                     (x + s_atlasTileSize - 0.5f) / atlasSize, (y + s_atlasTileSize - 0.5f) / atlasSize);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestStaticBatch::OnUpdate(float deltaTime)
+{
+    _time += deltaTime;
+    if ( _autoPan )
+    {
+        _center.x = s_mapSize * (0.5f + 0.4f * std::sin(_time * 0.1f));
+        _center.y = s_mapSize * (0.5f + 0.4f * std::sin(_time * 0.07f));
+    }
+
+    std::uniform_int_distribution<int> coord(0, s_mapSize - 1);
+    std::uniform_int_distribution<int> type(0, s_atlasTiles * s_atlasTiles - 1);
+    for ( int ee = 0; ee < _editsPerFrame; ++ee )
+    {
+        size_t index = (size_t)coord(_rng) * s_mapSize + coord(_rng);
+        _tiles[index] = (uint8_t)type(_rng);
+        _batch->SetUV(_ids[index], GetTileUV(_tiles[index]));
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestStaticBatch::DrawImmediate(const glm::vec2& visibleMin, const glm::vec2& visibleMax)
+{
+    Renderer renderer;
+
+    int x0 = std::max(0, (int)std::floor(visibleMin.x)), x1 = std::min(s_mapSize - 1, (int)std::floor(visibleMax.x));
+    int y0 = std::max(0, (int)std::floor(visibleMin.y)), y1 = std::min(s_mapSize - 1, (int)std::floor(visibleMax.y));
+
+    auto flush = [&]()
+    {
+        if ( _vertices.empty() )
+            return;
+
+        unsigned int bytes = (unsigned int)(_vertices.size() * sizeof(StaticBatch::Vertex));
+        _vbo->Stream(_vertices.data(), bytes);
+        renderer.Draw(*_vao, *_ibo, *_shader, (unsigned int)(_vertices.size() / 4u * 6u));
+        _uploadedBytes += bytes;
+        ++_drawCalls;
+        _vertices.clear();
+    };
+
+    StaticBatch::Sprite sprite;
+    sprite.size = glm::vec2(1.0f);
+    for ( int yy = y0; yy <= y1; ++yy )
+    {
+        for ( int xx = x0; xx <= x1; ++xx )
+        {
+            if ( _vertices.size() + 4u > (size_t)s_immediateQuads * 4u )
+                flush();
+
+            sprite.position = glm::vec2((float)xx, (float)yy);
+            sprite.uv = GetTileUV(_tiles[(size_t)yy * s_mapSize + xx]);
+            _vertices.resize(_vertices.size() + 4u);
+            StaticBatch::WriteQuad(sprite, &_vertices[_vertices.size() - 4u]);
+        }
+    }
+
+    flush();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestStaticBatch::OnRender()
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glm::vec2 half(480.0f / _zoom, 270.0f / _zoom);
+    glm::vec2 visibleMin = _center - half, visibleMax = _center + half;
+
+    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(480.0f, 270.0f, 0.0f));
+    view = glm::scale(view, glm::vec3(_zoom, _zoom, 1.0f));
+    view = glm::translate(view, glm::vec3(-_center.x, -_center.y, 0.0f));
+
+    _atlas->Bind(0);
+    _shader->Bind();
+    _shader->SetUniformMat4f("u_MVP", _projMat * view);
+
+    auto start = Clock::now();
+    if ( _retained )
+    {
+        _batch->Update();
+        _batch->Draw(*_shader, visibleMin, visibleMax);
+        _uploadedBytes = _batch->GetUploadedBytes();
+        _drawCalls = _batch->GetDrawnChunks();
+    }
+    else
+    {
+        // edits still land in the batch, only its uploads are skipped
+        _uploadedBytes = 0;
+        _drawCalls = 0;
+        DrawImmediate(visibleMin, visibleMax);
+    }
+    _cpuMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestStaticBatch::OnImGuiRender()
+{
+    ImGui::Checkbox("Retained chunks", &_retained);
+    ImGui::Checkbox("Auto pan", &_autoPan);
+    ImGui::SliderFloat("Zoom (pixels per tile)", &_zoom, 0.5f, 32.0f, "%.2f");
+    ImGui::SliderInt("Edits per frame", &_editsPerFrame, 0, 1000);
+
+    ImGui::Separator();
+    ImGui::Text("Tiles:        %d x %d in %u chunks", s_mapSize, s_mapSize, _batch->GetChunkCount());
+    ImGui::Text("Uploaded:     %.1f KB / frame", _uploadedBytes / 1024.0);
+    if ( _retained )
+        ImGui::Text("Dirty chunks: %u, %u ranges", _batch->GetDirtyChunks(), _batch->GetUploadRanges());
+    ImGui::Text("Draw calls:   %u", _drawCalls);
+    ImGui::Text("CPU:          %.3f ms", _cpuMs);
+}
+
+}
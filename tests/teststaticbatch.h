@@ -0,0 +1,74 @@
+#ifndef _teststaticbatch_h_
+#define _teststaticbatch_h_
+
+#include "test.h"
+#include "../vertexarray.h"
+#include "../vertexbuffer.h"
+#include "../indexbuffer.h"
+#include "../shader.h"
+#include "../texture.h"
+#include "../staticbatch.h"
+#include "../resourcemanager.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// A 1000 x 1000 tile map with a configurable number of random tile edits per
+// frame, drawn from retained chunks or rebuilt from scratch every frame.
+// -----------------------------------------------------------------------------
+class TestStaticBatch : public Test
+{
+public:
+
+    TestStaticBatch();
+    ~TestStaticBatch();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+    static void DeclareResources(SceneResources& resources);
+
+private:
+
+    glm::vec4 GetTileUV(uint8_t type) const;
+    void DrawImmediate(const glm::vec2& visibleMin, const glm::vec2& visibleMax);
+
+    ResourceRef<Shader>             _shader;
+    std::unique_ptr<Texture>        _atlas;
+    std::unique_ptr<StaticBatch>    _batch;
+
+    // rebuild-every-frame path
+    std::unique_ptr<VertexArray>    _vao;
+    std::unique_ptr<VertexBuffer>   _vbo;
+    std::unique_ptr<IndexBuffer>    _ibo;
+    std::vector<StaticBatch::Vertex> _vertices;
+
+    std::vector<uint8_t>            _tiles;
+    std::vector<unsigned int>       _ids;
+    std::mt19937                    _rng;
+
+    glm::mat4                       _projMat;
+    glm::vec2                       _center;
+    float                           _zoom           = 2.0f;     // pixels per tile
+    float                           _time           = 0.0f;
+    bool                            _autoPan        = true;
+    bool                            _retained       = true;
+    int                             _editsPerFrame  = 16;
+
+    size_t                          _uploadedBytes  = 0;
+    unsigned int                    _drawCalls      = 0;
+    double                          _cpuMs          = 0.0;
+};
+
+}
+
+#endif // _teststaticbatch_h_
@@ -0,0 +1,126 @@
+#include "testtextbench.h"
+#include "../renderer.h"
+#include <imgui.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestTextBench::TestTextBench()
+    : _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+{
+    _font = std::make_unique<SdfFont>("res/fonts/text.ttf");
+    _text = std::make_unique<TextRenderer>(*_font);
+
+    Generate();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestTextBench::~TestTextBench()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextBench::Generate()
+{
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> x(0.0f, 900.0f), y(0.0f, 460.0f);
+
+    char buffer[32];
+    _labels.resize(_labelCount);
+    _positions.resize(_labelCount);
+    for ( int ii = 0; ii < _labelCount; ++ii )
+    {
+        std::snprintf(buffer, sizeof(buffer), "Label #%05d", ii);
+        _labels[ii] = buffer;
+        _positions[ii] = glm::vec2(x(rng), y(rng));
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextBench::OnUpdate(float deltaTime)
+{
+    _time += deltaTime;
+    if ( (int)_labels.size() != _labelCount )
+        Generate();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextBench::OnRender()
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    glClearColor( 0.1f, 0.1f, 0.12f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    auto start = Clock::now();
+
+    _text->Begin(_projMat);
+
+    // the first share of labels carries a value that changes every frame
+    int dynamicCount = _labelCount * _dynamicPercent / 100;
+    char buffer[32];
+    for ( int ii = 0; ii < _labelCount; ++ii )
+    {
+        glm::vec4 color(0.5f + 0.5f * (ii % 7) / 6.0f, 0.8f, 0.5f + 0.5f * (ii % 5) / 4.0f, 1.0f);
+        if ( ii < dynamicCount )
+        {
+            std::snprintf(buffer, sizeof(buffer), "Value %u", (unsigned int)(ii * 7919u + _frame));
+            _text->AddText(buffer, _positions[ii], _labelSize, color);
+        }
+        else
+        {
+            _text->AddText(_labels[ii].c_str(), _positions[ii], _labelSize, color);
+        }
+    }
+
+    _text->AddText("Signed distance field text", glm::vec2(20.0f, 480.0f), _titleSize, glm::vec4(1.0f));
+
+    _text->End();
+
+    _cpuMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    ++_frame;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextBench::OnImGuiRender()
+{
+    ImGui::SliderInt("Labels", &_labelCount, 100, 20000);
+    ImGui::SliderInt("Changing every frame (%)", &_dynamicPercent, 0, 100);
+    ImGui::SliderFloat("Label size", &_labelSize, 4.0f, 48.0f);
+    ImGui::SliderFloat("Title size", &_titleSize, 8.0f, 256.0f);
+
+    ImGui::Separator();
+    if ( _font->IsFallback() )
+        ImGui::TextDisabled("res/fonts/text.ttf not found, using the ImGui font");
+
+    uint64_t runHits = _text->GetRunHits(), runMisses = _text->GetRunMisses();
+    uint64_t glyphHits = _font->GetHits(), glyphMisses = _font->GetMisses();
+    double runRate = runHits + runMisses ? 100.0 * runHits / (runHits + runMisses) : 0.0;
+    double glyphRate = glyphHits + glyphMisses ? 100.0 * glyphHits / (glyphHits + glyphMisses) : 0.0;
+
+    ImGui::Text("Glyphs / frame:   %u", _text->GetGlyphsLastFrame());
+    ImGui::Text("Draw calls:       %u", _text->GetDrawCallsLastFrame());
+    ImGui::Text("CPU build + draw: %.3f ms", _cpuMs);
+    ImGui::Text("Run cache:        %.1f%% hits, %u runs", runRate, _text->GetCachedRunCount());
+    ImGui::Text("Glyph cache:      %.1f%% hits, %u glyphs, atlas generation %u", glyphRate,
+                _font->GetGlyphCount(), _font->GetGeneration());
+
+    // rates are per frame
+    _text->ResetCounters();
+    _font->ResetCounters();
+}
+
+}
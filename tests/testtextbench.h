@@ -0,0 +1,56 @@
+#ifndef _testtextbench_h_
+#define _testtextbench_h_
+
+#include "test.h"
+#include "../sdffont.h"
+#include "../textrenderer.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Draws a configurable number of labels through the batched SDF text renderer.
+// A share of them changes every frame so the layout cache has to shape them
+// again, the rest stay the same and should hit the cache.
+// -----------------------------------------------------------------------------
+class TestTextBench : public Test
+{
+public:
+
+    TestTextBench();
+    ~TestTextBench();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+private:
+
+    void Generate();
+
+    std::unique_ptr<SdfFont>        _font;
+    std::unique_ptr<TextRenderer>   _text;
+
+    glm::mat4                       _projMat;
+
+    std::vector<std::string>        _labels;
+    std::vector<glm::vec2>          _positions;
+
+    int                             _labelCount     = 10000;
+    int                             _dynamicPercent = 10;
+    float                           _labelSize      = 10.0f;
+    float                           _titleSize      = 64.0f;
+    float                           _time           = 0.0f;
+    unsigned int                    _frame          = 0;
+    double                          _cpuMs          = 0.0;
+};
+
+}
+
+#endif // _testtextbench_h_
@@ -1,10 +1,19 @@
 #include "testtexture2d.h"
 #include "../renderer.h"
+#include "../scenepreparer.h"
 #include <imgui.h>
 
 namespace test
 {
 
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTexture2D::DeclareResources(SceneResources& resources)
+{
+    resources.shaders.push_back("res/shaders/material.shader");
+    resources.textures.push_back("res/textures/sample.jpg");
+}
+
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 TestTexture2D::TestTexture2D()
@@ -21,25 +30,22 @@ TestTexture2D::TestTexture2D()
     unsigned int indices[] = { 0, 1, 2,
                                2, 3, 0 };
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    _vao = std::make_unique<VertexArray>();
-    _vbo = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+    ResourceManager& resources = ResourceManager::Get();
+    _vbo = resources.LoadVertexBuffer(positions, 4 * 4 * sizeof(float));
 
     VertexBufferLayout layout;
     layout.Push<float>(2);
     layout.Push<float>(2);
-    _vao->AddBuffer(*_vbo, layout);
+    _vao = resources.LoadVertexArray(_vbo, layout);
 
-    _ibo = std::make_unique<IndexBuffer>(indices, 6);
+    _ibo = resources.LoadIndexBuffer(indices, 6);
 
-    _shader = std::make_unique<Shader>("res/shaders/basic.shader");
-    _shader->Bind();
+    _shader = resources.LoadShader("res/shaders/material.shader");
+    _texture = resources.LoadTexture("res/textures/sample.jpg");
 
-    _texture = std::make_unique<Texture>("res/textures/sample.jpg");
-    _texture->Bind(0);
-    _shader->SetUniform1i("u_Texture", 0);
+    // the jpeg has no alpha so this is drawn opaque, without blending
+    _material = std::make_unique<Material>(*_shader, *_texture);
+    _queue = std::make_unique<RenderQueue>();
 }
 
 // -----------------------------------------------------------------------------
@@ -58,30 +64,12 @@ void TestTexture2D::OnUpdate(float deltaTime)
 // -----------------------------------------------------------------------------
 void TestTexture2D::OnRender()
 {
-    Renderer renderer;
     glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
     glClear(GL_COLOR_BUFFER_BIT);
 
-    {
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), _translationA);
-        glm::mat4 mvp = _projMat * _viewMat * model;
-
-        _shader->SetUniformMat4f("u_MVP", mvp);
-
-        _shader->Bind();
-        renderer.Draw(*_vao, *_ibo, *_shader);
-    }
-
-    {
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), _translationB);
-        glm::mat4 mvp = _projMat * _viewMat * model;
-
-        _shader->SetUniformMat4f("u_MVP", mvp);
-
-        _shader->Bind();
-        renderer.Draw(*_vao, *_ibo, *_shader);
-    }
-
+    _queue->Submit(*_vao, *_ibo, *_material, glm::translate(glm::mat4(1.0f), _translationA));
+    _queue->Submit(*_vao, *_ibo, *_material, glm::translate(glm::mat4(1.0f), _translationB));
+    _queue->Flush(_projMat * _viewMat);
 }
 
 // -----------------------------------------------------------------------------
@@ -90,6 +78,8 @@ void TestTexture2D::OnImGuiRender()
 {
     ImGui::SliderFloat3("TranslateA", &_translationA.x, 0.0f, 960.0f);
     ImGui::SliderFloat3("TranslateB", &_translationB.x, 0.0f, 960.0f);
+    ImGui::Separator();
+    _queue->OnImGuiRender();
 }
 
 }
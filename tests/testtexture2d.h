@@ -8,6 +8,9 @@
 #include "../indexbuffer.h"
 #include "../shader.h"
 #include "../texture.h"
+#include "../resourcemanager.h"
+#include "../material.h"
+#include "../renderqueue.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -30,13 +33,17 @@ public:
     void OnRender() override;
     void OnImGuiRender() override;
 
+    static void DeclareResources(SceneResources& resources);
+
 private:
 
-    std::unique_ptr<VertexArray>    _vao;
-    std::unique_ptr<VertexBuffer>   _vbo;
-    std::unique_ptr<IndexBuffer>    _ibo;
-    std::unique_ptr<Shader>         _shader;
-    std::unique_ptr<Texture>        _texture;
+    ResourceRef<VertexArray>        _vao;
+    ResourceRef<VertexBuffer>       _vbo;
+    ResourceRef<IndexBuffer>        _ibo;
+    ResourceRef<Shader>             _shader;
+    ResourceRef<Texture>            _texture;
+    std::unique_ptr<Material>       _material;
+    std::unique_ptr<RenderQueue>    _queue;
 
     glm::mat4                       _viewMat;
     glm::mat4                       _projMat;
@@ -0,0 +1,131 @@
+#include "testtexturestress.h"
+#include "../scenepreparer.h"
+#include "../renderer.h"
+#include "../textureresidency.h"
+#include <imgui.h>
+
+namespace test
+{
+
+static const int s_textureCount = 48;
+static const int s_textureSize  = 1024;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextureStress::DeclareResources(SceneResources& resources)
+{
+    resources.shaders.push_back("res/shaders/basic.shader");
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestTextureStress::TestTextureStress()
+    : _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+{
+    float positions[] = { -50.0f, -50.0f, 0.0f, 0.0f,
+                           50.0f, -50.0f, 1.0f, 0.0f,
+                           50.0f,  50.0f, 1.0f, 1.0f,
+                          -50.0f,  50.0f, 0.0f, 1.0f };
+
+    unsigned int indices[] = { 0, 1, 2,
+                               2, 3, 0 };
+
+    _vao = std::make_unique<VertexArray>();
+    _vbo = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    _vao->AddBuffer(*_vbo, layout);
+
+    _ibo = std::make_unique<IndexBuffer>(indices, 6);
+
+    _shader = ResourceManager::Get().LoadShader("res/shaders/basic.shader");
+    _shader->Bind();
+    _shader->SetUniform1i("u_Texture", 0);
+
+    TextureResidency& residency = TextureResidency::Get();
+    _previousBudget = residency.GetBudget();
+    residency.SetBudget((size_t)_budgetMB * 1024u * 1024u);
+
+    // procedural textures keep their cpu copy so they can be restored
+    std::vector<unsigned char> pixels((size_t)s_textureSize * s_textureSize * 4u);
+    for ( int tt = 0; tt < s_textureCount; ++tt )
+    {
+        unsigned char r = (unsigned char)(37 * tt);
+        unsigned char g = (unsigned char)(91 * tt);
+        unsigned char* p = pixels.data();
+        for ( int yy = 0; yy < s_textureSize; ++yy )
+        {
+            for ( int xx = 0; xx < s_textureSize; ++xx, p += 4 )
+            {
+                bool checker = ((xx >> 6) ^ (yy >> 6)) & 1;
+                p[0] = checker ? r : 255;
+                p[1] = checker ? g : (unsigned char)xx;
+                p[2] = (unsigned char)yy;
+                p[3] = 255;
+            }
+        }
+
+        _textures.push_back(std::make_unique<Texture>(s_textureSize, s_textureSize, pixels.data()));
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestTextureStress::~TestTextureStress()
+{
+    _textures.clear();
+    TextureResidency::Get().SetBudget(_previousBudget);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextureStress::OnUpdate(float deltaTime)
+{
+    if ( ++_frame % (unsigned int)_framesPerStep == 0 )
+        _first = (_first + 1) % s_textureCount;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextureStress::OnRender()
+{
+    Renderer renderer;
+    glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    for ( int ii = 0; ii < _visibleCount; ++ii )
+    {
+        const Texture& texture = *_textures[(_first + ii) % s_textureCount];
+        texture.Bind(0);
+
+        glm::vec3 translation(80.0f + 110.0f * (ii % 8), 400.0f - 110.0f * (ii / 8), 0.0f);
+        glm::mat4 mvp = _projMat * glm::translate(glm::mat4(1.0f), translation);
+
+        _shader->Bind();
+        _shader->SetUniformMat4f("u_MVP", mvp);
+        renderer.Draw(*_vao, *_ibo, *_shader);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTextureStress::OnImGuiRender()
+{
+    const float mb = 1.0f / (1024.0f * 1024.0f);
+    const size_t textureBytes = (size_t)s_textureSize * s_textureSize * 4u;
+
+    ImGui::Text("%d textures, %.1f MB of texture data", s_textureCount, s_textureCount * textureBytes * mb);
+    if ( ImGui::SliderInt("Budget (MB)", &_budgetMB, 8, 256) )
+        TextureResidency::Get().SetBudget((size_t)_budgetMB * 1024u * 1024u);
+
+    ImGui::SliderInt("Visible", &_visibleCount, 1, 32);
+    ImGui::SliderInt("Frames per step", &_framesPerStep, 1, 60);
+
+    TextureResidency& residency = TextureResidency::Get();
+    ImGui::Text("Resident: %.2f MB", residency.GetResidentBytes() * mb);
+    ImGui::Text("Uploads: %zu  Evictions: %zu", residency.GetUploadCount(), residency.GetEvictionCount());
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef _testtexturestress_h_
+#define _testtexturestress_h_
+
+#include "test.h"
+#include "../vertexarray.h"
+#include "../vertexbufferlayout.h"
+#include "../vertexbuffer.h"
+#include "../indexbuffer.h"
+#include "../shader.h"
+#include "../texture.h"
+#include "../resourcemanager.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Cycles through far more texture data than the residency budget allows so
+// that eviction and re-upload happen continuously.
+// -----------------------------------------------------------------------------
+class TestTextureStress : public Test
+{
+public:
+
+    TestTextureStress();
+    ~TestTextureStress();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+    static void DeclareResources(SceneResources& resources);
+
+private:
+
+    std::unique_ptr<VertexArray>    _vao;
+    std::unique_ptr<VertexBuffer>   _vbo;
+    std::unique_ptr<IndexBuffer>    _ibo;
+    ResourceRef<Shader>             _shader;
+    std::vector<std::unique_ptr<Texture>> _textures;
+
+    glm::mat4                       _projMat;
+
+    size_t                          _previousBudget = 0;
+    int                             _budgetMB       = 32;
+    int                             _visibleCount   = 8;
+    int                             _framesPerStep  = 1;
+    unsigned int                    _frame          = 0;
+    unsigned int                    _first          = 0;
+};
+
+}
+
+#endif // _testtexturestress_h_
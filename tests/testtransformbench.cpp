@@ -0,0 +1,116 @@
+#include "testtransformbench.h"
+#include <imgui.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestTransformBench::TestTransformBench()
+    : _viewMat(glm::translate(glm::mat4(1.0f), glm::vec3(-100.0f, 0.0f, 0.0f))),
+      _projMat(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestTransformBench::~TestTransformBench()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTransformBench::Generate()
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    _transforms.Clear();
+    _transforms.Reserve(_count);
+    for ( int ii = 0; ii < _count; ++ii )
+    {
+        glm::vec3 position(unit(rng) * 960.0f, unit(rng) * 540.0f, 0.0f);
+        glm::quat rotation = glm::angleAxis(unit(rng) * 6.2831853f, glm::vec3(0.0f, 0.0f, 1.0f));
+        glm::vec3 scale(0.5f + unit(rng), 0.5f + unit(rng), 1.0f);
+        _transforms.Add(position, rotation, scale);
+    }
+
+    _reference.resize(_count);
+    _output.resize(_count);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTransformBench::Run()
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    if ( (int)_transforms.GetCount() != _count )
+        Generate();
+
+    _results.clear();
+
+    // what TestTexture2D does for every object
+    auto start = Clock::now();
+    for ( int ii = 0; ii < _count; ++ii )
+    {
+        glm::quat rotation(_transforms.qw[ii], _transforms.qx[ii], _transforms.qy[ii], _transforms.qz[ii]);
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(_transforms.px[ii], _transforms.py[ii], _transforms.pz[ii]));
+        model = model * glm::mat4_cast(rotation);
+        model = glm::scale(model, glm::vec3(_transforms.sx[ii], _transforms.sy[ii], _transforms.sz[ii]));
+        _reference[ii] = _projMat * _viewMat * model;
+    }
+    _results.push_back({ "glm per object", std::chrono::duration<double, std::milli>(Clock::now() - start).count(), 0.0f });
+
+    TransformKernel::Kernel active = TransformKernel::GetKernel();
+    for ( auto kernel : { TransformKernel::Kernel::Scalar, TransformKernel::Kernel::SSE, TransformKernel::Kernel::AVX2 } )
+    {
+        if ( !TransformKernel::IsSupported(kernel) )
+            continue;
+
+        TransformKernel::SetKernel(kernel);
+
+        start = Clock::now();
+        glm::mat4 viewProj = _projMat * _viewMat;
+        TransformKernel::ComputeClipMatrices(_transforms, viewProj, 0, _count, _output.data());
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        float maxError = 0.0f;
+        for ( int ii = 0; ii < _count; ++ii )
+        {
+            const float* a = &_output[ii][0][0];
+            const float* b = &_reference[ii][0][0];
+            for ( int jj = 0; jj < 16; ++jj )
+                maxError = std::fmax(maxError, std::fabs(a[jj] - b[jj]));
+        }
+
+        _results.push_back({ TransformKernel::GetName(kernel), ms, maxError });
+    }
+
+    TransformKernel::SetKernel(active);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestTransformBench::OnImGuiRender()
+{
+    ImGui::Text("Active kernel: %s", TransformKernel::GetName(TransformKernel::GetKernel()));
+    ImGui::SliderInt("Transforms", &_count, 1000, 4000000);
+
+    if ( ImGui::Button("Run") )
+        Run();
+
+    for ( const Result& result : _results )
+    {
+        double speedup = _results.front().milliseconds / result.milliseconds;
+        ImGui::Text("%-16s %8.2f ms  x%.2f  max error %g", result.name, result.milliseconds, speedup, result.maxError);
+    }
+}
+
+}
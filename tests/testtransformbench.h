@@ -0,0 +1,52 @@
+#ifndef _testtransformbench_h_
+#define _testtransformbench_h_
+
+#include "test.h"
+#include "../transform.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Compares per object glm model/view/projection products against the batched
+// SoA transform kernels.
+// -----------------------------------------------------------------------------
+class TestTransformBench : public Test
+{
+public:
+
+    TestTransformBench();
+    ~TestTransformBench();
+
+    void OnImGuiRender() override;
+
+private:
+
+    void Generate();
+    void Run();
+
+    struct Result
+    {
+        const char* name;
+        double      milliseconds;
+        float       maxError;
+    };
+
+    TransformSoA            _transforms;
+    std::vector<glm::mat4>  _reference;
+    std::vector<glm::mat4>  _output;
+
+    glm::mat4               _viewMat;
+    glm::mat4               _projMat;
+
+    int                     _count = 1000000;
+    std::vector<Result>     _results;
+};
+
+}
+
+#endif // _testtransformbench_h_
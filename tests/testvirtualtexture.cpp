@@ -0,0 +1,134 @@
+#include "testvirtualtexture.h"
+#include "../scenepreparer.h"
+#include "../renderer.h"
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace test
+{
+
+static const float s_viewWidth  = 960.0f;
+static const float s_viewHeight = 540.0f;
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestVirtualTexture::DeclareResources(SceneResources& resources)
+{
+    resources.shaders.push_back("res/shaders/virtualtexture.shader");
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestVirtualTexture::TestVirtualTexture()
+    : _projMat(glm::ortho(0.0f, s_viewWidth, 0.0f, s_viewHeight, -1.0f, 1.0f))
+{
+    float positions[] = { 0.0f,        0.0f,         0.0f, 0.0f,
+                          s_viewWidth, 0.0f,         1.0f, 0.0f,
+                          s_viewWidth, s_viewHeight, 1.0f, 1.0f,
+                          0.0f,        s_viewHeight, 0.0f, 1.0f };
+
+    unsigned int indices[] = { 0, 1, 2,
+                               2, 3, 0 };
+
+    _vao = std::make_unique<VertexArray>();
+    _vbo = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    _vao->AddBuffer(*_vbo, layout);
+
+    _ibo = std::make_unique<IndexBuffer>(indices, 6);
+
+    _shader = ResourceManager::Get().LoadShader("res/shaders/virtualtexture.shader");
+
+    std::unique_ptr<TileSource> source;
+    auto file = std::make_unique<MappedTileFile>();
+    if ( file->Open("res/textures/virtual.vt") )
+    {
+        source = std::move(file);
+        _fromFile = true;
+    }
+    else
+    {
+        source = std::make_unique<ProceduralTileSource>(65536, 65536);
+    }
+
+    _texture = std::make_unique<VirtualTexture>(std::move(source));
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TestVirtualTexture::~TestVirtualTexture()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestVirtualTexture::OnUpdate(float deltaTime)
+{
+    _time += deltaTime;
+    if ( _autoPan )
+    {
+        _centerX = 0.5f + 0.35f * std::sin(_time * 0.05f);
+        _centerY = 0.5f + 0.35f * std::sin(_time * 0.037f);
+        _zoomLog2 = 3.0f + 3.0f * std::sin(_time * 0.11f);
+    }
+
+    const TileFileHeader& header = _texture->GetHeader();
+    float texelsPerPixel = std::exp2(_zoomLog2);
+    glm::vec2 center(_centerX * header.width, _centerY * header.height);
+    glm::vec2 half(0.5f * s_viewWidth * texelsPerPixel, 0.5f * s_viewHeight * texelsPerPixel);
+
+    _texture->SetUploadBudget(_uploadBudget);
+    _texture->Update(center - half, center + half, texelsPerPixel);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestVirtualTexture::OnRender()
+{
+    glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    const TileFileHeader& header = _texture->GetHeader();
+    float texelsPerPixel = std::exp2(_zoomLog2);
+    float extentX = s_viewWidth * texelsPerPixel / header.width;
+    float extentY = s_viewHeight * texelsPerPixel / header.height;
+
+    Renderer renderer;
+
+    _texture->Bind(0, 1);
+    _shader->Bind();
+    _texture->SetUniforms(*_shader, 0, 1);
+    _shader->SetUniform2f("u_UVOrigin", _centerX - 0.5f * extentX, _centerY - 0.5f * extentY);
+    _shader->SetUniform2f("u_UVExtent", extentX, extentY);
+    _shader->SetUniformMat4f("u_MVP", _projMat);
+    renderer.Draw(*_vao, *_ibo, *_shader);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TestVirtualTexture::OnImGuiRender()
+{
+    const TileFileHeader& header = _texture->GetHeader();
+
+    ImGui::Text("Source: %s, %u x %u, %u levels", _fromFile ? "res/textures/virtual.vt" : "procedural",
+                header.width, header.height, header.mipCount);
+    ImGui::Checkbox("Auto pan", &_autoPan);
+    ImGui::SliderFloat("Center X", &_centerX, 0.0f, 1.0f);
+    ImGui::SliderFloat("Center Y", &_centerY, 0.0f, 1.0f);
+    ImGui::SliderFloat("Zoom (log2 texels/pixel)", &_zoomLog2, -2.0f, (float)header.mipCount);
+    ImGui::SliderFloat("Upload budget (ms)", &_uploadBudget, 0.1f, 8.0f);
+
+    ImGui::Separator();
+    ImGui::Text("Requested mip:   %u", _texture->GetRequestedMip());
+    ImGui::Text("Resident tiles:  %u / %u", _texture->GetResidentCount(), _texture->GetCacheCapacity());
+    ImGui::Text("Pending tiles:   %u", _texture->GetPendingCount());
+    ImGui::Text("Uploads / frame: %u", _texture->GetUploadsLastFrame());
+    ImGui::Text("GPU memory:      %.2f MB", _texture->GetGpuBytes() / (1024.0 * 1024.0));
+}
+
+}
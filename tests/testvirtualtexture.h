@@ -0,0 +1,60 @@
+#ifndef _testvirtualtexture_h_
+#define _testvirtualtexture_h_
+
+#include "test.h"
+#include "../vertexarray.h"
+#include "../vertexbufferlayout.h"
+#include "../vertexbuffer.h"
+#include "../indexbuffer.h"
+#include "../shader.h"
+#include "../virtualtexture.h"
+#include "../resourcemanager.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+
+namespace test
+{
+
+// -----------------------------------------------------------------------------
+// Pans and zooms over an image far larger than GPU memory. Uses a cooked
+// res/textures/virtual.vt when there is one and a procedural 64k x 64k source
+// otherwise.
+// -----------------------------------------------------------------------------
+class TestVirtualTexture : public Test
+{
+public:
+
+    TestVirtualTexture();
+    ~TestVirtualTexture();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnImGuiRender() override;
+
+    static void DeclareResources(SceneResources& resources);
+
+private:
+
+    std::unique_ptr<VertexArray>    _vao;
+    std::unique_ptr<VertexBuffer>   _vbo;
+    std::unique_ptr<IndexBuffer>    _ibo;
+    ResourceRef<Shader>             _shader;
+    std::unique_ptr<VirtualTexture> _texture;
+
+    glm::mat4                       _projMat;
+
+    bool                            _fromFile       = false;
+    bool                            _autoPan        = true;
+    float                           _centerX        = 0.5f;
+    float                           _centerY        = 0.5f;
+    float                           _zoomLog2       = 4.0f;    // log2 texels per pixel
+    float                           _time           = 0.0f;
+    float                           _uploadBudget   = 2.0f;
+};
+
+}
+
+#endif // _testvirtualtexture_h_
@@ -0,0 +1,266 @@
+#include "renderer.h"
+#include "textrenderer.h"
+#include "vertexbufferlayout.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint64_t HashString(const char* text)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for ( ; *text; ++text )
+    {
+        hash ^= (unsigned char)*text;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint32_t DecodeUtf8(const char*& text)
+{
+    const unsigned char* p = (const unsigned char*)text;
+    uint32_t codepoint = *p++;
+    int extra = 0;
+    if ( codepoint >= 0xF0 )
+    {
+        codepoint &= 0x07;
+        extra = 3;
+    }
+    else if ( codepoint >= 0xE0 )
+    {
+        codepoint &= 0x0F;
+        extra = 2;
+    }
+    else if ( codepoint >= 0xC0 )
+    {
+        codepoint &= 0x1F;
+        extra = 1;
+    }
+
+    for ( ; extra > 0 && (*p & 0xC0) == 0x80; --extra )
+        codepoint = (codepoint << 6) | (*p++ & 0x3F);
+
+    text = (const char*)p;
+    return extra ? 0xFFFD : codepoint;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint32_t PackColor(const glm::vec4& color)
+{
+    auto channel = [](float c) { return (uint32_t)(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (channel(color.w) << 24);
+}
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TextRenderer::TextRenderer(SdfFont& font)
+    : _font(font),
+      _viewProj(1.0f),
+      _seen(s_seenSlots, 0)
+{
+    std::vector<unsigned int> indices((size_t)s_maxQuads * 6u);
+    for ( unsigned int qq = 0; qq < s_maxQuads; ++qq )
+    {
+        unsigned int* index = &indices[(size_t)qq * 6u];
+        unsigned int base = qq * 4u;
+        index[0] = base + 0;
+        index[1] = base + 1;
+        index[2] = base + 2;
+        index[3] = base + 2;
+        index[4] = base + 3;
+        index[5] = base + 0;
+    }
+
+    _vao = std::make_unique<VertexArray>();
+    _vbo = std::make_unique<VertexBuffer>(nullptr, s_maxQuads * 4u * (unsigned int)sizeof(Vertex), GL_STREAM_DRAW);
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    layout.Push<unsigned char>(4);
+    _vao->AddBuffer(*_vbo, layout);
+
+    _ibo = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+    _shader = std::make_unique<Shader>("res/shaders/sdftext.shader");
+
+    _vertices.reserve((size_t)s_maxQuads * 4u);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TextRenderer::~TextRenderer()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextRenderer::Begin(const glm::mat4& viewProj)
+{
+    _viewProj = viewProj;
+    _vertices.clear();
+    _glyphs = 0;
+    _drawCalls = 0;
+    ++_frame;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextRenderer::Shape(const char* text, Run& run)
+{
+    run.glyphs.clear();
+    run.complete = true;
+    run.generation = _font.GetGeneration();
+
+    float penX = 0.0f, penY = 0.0f;
+    uint32_t previous = 0;
+    while ( *text )
+    {
+        uint32_t codepoint = DecodeUtf8(text);
+        if ( codepoint == '\n' )
+        {
+            penX = 0.0f;
+            penY -= _font.GetLineHeight();
+            previous = 0;
+            continue;
+        }
+
+        const SdfGlyph* glyph = _font.GetGlyph(codepoint);
+        if ( !glyph )
+        {
+            run.complete = false;
+            continue;
+        }
+
+        if ( previous )
+            penX += _font.GetKerning(previous, codepoint);
+
+        if ( glyph->visible )
+        {
+            run.glyphs.push_back({ penX + glyph->x0, penY + glyph->y0, penX + glyph->x1, penY + glyph->y1,
+                                   glyph->u0, glyph->v0, glyph->u1, glyph->v1 });
+        }
+
+        penX += glyph->advance;
+        previous = codepoint;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const TextRenderer::Run& TextRenderer::GetRun(const char* text)
+{
+    uint64_t hash = HashString(text);
+    auto it = _runs.find(hash);
+    if ( it != _runs.end() && it->second.generation == _font.GetGeneration() && it->second.text == text )
+    {
+        ++_runHits;
+        it->second.lastUsed = _frame;
+        return it->second;
+    }
+
+    ++_runMisses;
+
+    // runs missing glyphs because the atlas filled up are not worth keeping,
+    // and strings seen for the first time are laid out without caching so
+    // text that changes every frame does not fill the cache
+    Shape(text, _scratch);
+    if ( !_scratch.complete )
+        return _scratch;
+
+    uint64_t& seen = _seen[hash & (s_seenSlots - 1)];
+    if ( seen != hash || _runs.size() >= s_maxRuns )
+    {
+        seen = hash;
+        return _scratch;
+    }
+
+    Run& run = _runs[hash];
+    run.text = text;
+    run.glyphs.swap(_scratch.glyphs);
+    run.generation = _scratch.generation;
+    run.lastUsed = _frame;
+    run.complete = true;
+    return run;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextRenderer::AddText(const char* text, const glm::vec2& position, float size, const glm::vec4& color)
+{
+    const Run& run = GetRun(text);
+    float scale = size / _font.GetBakeSize();
+    uint32_t packed = PackColor(color);
+
+    for ( const RunGlyph& glyph : run.glyphs )
+    {
+        if ( _vertices.size() + 4u > (size_t)s_maxQuads * 4u )
+            Flush();
+
+        float x0 = position.x + glyph.x0 * scale, x1 = position.x + glyph.x1 * scale;
+        float y0 = position.y + glyph.y0 * scale, y1 = position.y + glyph.y1 * scale;
+        _vertices.push_back({ x0, y0, glyph.u0, glyph.v0, packed });
+        _vertices.push_back({ x1, y0, glyph.u1, glyph.v0, packed });
+        _vertices.push_back({ x1, y1, glyph.u1, glyph.v1, packed });
+        _vertices.push_back({ x0, y1, glyph.u0, glyph.v1, packed });
+    }
+
+    _glyphs += (unsigned int)run.glyphs.size();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextRenderer::Flush()
+{
+    if ( _vertices.empty() )
+        return;
+
+    _vbo->Stream(_vertices.data(), (unsigned int)(_vertices.size() * sizeof(Vertex)));
+
+    _font.Bind(0);
+    _shader->Bind();
+    _shader->SetUniform1i("u_Atlas", 0);
+    _shader->SetUniformMat4f("u_MVP", _viewProj);
+    _vao->Bind();
+    _ibo->Bind();
+    glDrawElements(GL_TRIANGLES, (GLsizei)(_vertices.size() / 4u * 6u), GL_UNSIGNED_INT, nullptr);
+
+    _vertices.clear();
+    ++_drawCalls;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextRenderer::End()
+{
+    Flush();
+
+    _glyphsLastFrame = _glyphs;
+    _drawCallsLastFrame = _drawCalls;
+
+    // glyphs that did not fit are picked up next frame in a fresh atlas
+    if ( _font.IsFull() )
+        _font.Reset();
+
+    if ( _frame % s_runLifetime == 0 )
+    {
+        for ( auto it = _runs.begin(); it != _runs.end(); )
+        {
+            if ( _frame - it->second.lastUsed > s_runLifetime || it->second.generation != _font.GetGeneration() )
+                it = _runs.erase(it);
+            else
+                ++it;
+        }
+    }
+}
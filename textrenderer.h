@@ -0,0 +1,122 @@
+#ifndef _textrenderer_h_
+#define _textrenderer_h_
+
+#include "vertexarray.h"
+#include "vertexbuffer.h"
+#include "indexbuffer.h"
+#include "shader.h"
+#include "sdffont.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Batches all text of a frame into one streaming vertex buffer and draws it
+// with a single SDF shader. Strings seen again are cached by content so labels
+// that do not change are only shaped once; per frame work for them is a scale,
+// an offset and a color.
+// -----------------------------------------------------------------------------
+class TextRenderer
+{
+public:
+
+    explicit TextRenderer(SdfFont& font);
+    ~TextRenderer();
+
+    void Begin(const glm::mat4& viewProj);
+    // position is the baseline start of the first line, size in pixels
+    void AddText(const char* text, const glm::vec2& position, float size, const glm::vec4& color);
+    void End();
+
+    inline unsigned int GetGlyphsLastFrame() const
+    {
+        return _glyphsLastFrame;
+    }
+
+    inline unsigned int GetDrawCallsLastFrame() const
+    {
+        return _drawCallsLastFrame;
+    }
+
+    inline uint64_t GetRunHits() const
+    {
+        return _runHits;
+    }
+
+    inline uint64_t GetRunMisses() const
+    {
+        return _runMisses;
+    }
+
+    inline unsigned int GetCachedRunCount() const
+    {
+        return (unsigned int)_runs.size();
+    }
+
+    inline void ResetCounters()
+    {
+        _runHits = _runMisses = 0;
+    }
+
+private:
+
+    struct Vertex
+    {
+        float       x, y;
+        float       u, v;
+        uint32_t    color;
+    };
+
+    struct RunGlyph
+    {
+        float       x0, y0, x1, y1;
+        float       u0, v0, u1, v1;
+    };
+
+    struct Run
+    {
+        std::string             text;
+        std::vector<RunGlyph>   glyphs;
+        uint32_t                generation  = 0;
+        unsigned int            lastUsed    = 0;
+        bool                    complete    = true;
+    };
+
+    const Run& GetRun(const char* text);
+    void Shape(const char* text, Run& run);
+    void Flush();
+
+    SdfFont&                        _font;
+
+    std::unique_ptr<VertexArray>    _vao;
+    std::unique_ptr<VertexBuffer>   _vbo;
+    std::unique_ptr<IndexBuffer>    _ibo;
+    std::unique_ptr<Shader>         _shader;
+
+    std::vector<Vertex>             _vertices;
+    glm::mat4                       _viewProj;
+
+    std::unordered_map<uint64_t, Run>   _runs;
+    Run                                 _scratch;
+    std::vector<uint64_t>               _seen;      // hashes of strings laid out once, direct mapped
+
+    unsigned int                    _frame              = 0;
+    unsigned int                    _glyphs             = 0;
+    unsigned int                    _drawCalls          = 0;
+    unsigned int                    _glyphsLastFrame    = 0;
+    unsigned int                    _drawCallsLastFrame = 0;
+    uint64_t                        _runHits            = 0;
+    uint64_t                        _runMisses          = 0;
+
+    static constexpr unsigned int   s_maxQuads          = 1u << 17;
+    static constexpr unsigned int   s_runLifetime       = 120;
+    static constexpr unsigned int   s_maxRuns           = 16384;
+    static constexpr unsigned int   s_seenSlots         = 1u << 14;
+};
+
+#endif // _textrenderer_h_
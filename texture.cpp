@@ -1,5 +1,8 @@
 #include "texture.h"
 #include "renderer.h"
+#include "resourcememory.h"
+#include "textureresidency.h"
+#include "glcapture.h"
 #include <stb_image.h>
 
 // -----------------------------------------------------------------------------
@@ -7,8 +10,79 @@
 Texture::Texture(const std::string& filePath)
     : _filePath(filePath)
 {
-    stbi_set_flip_vertically_on_load(1);
-    _localBuffer = stbi_load(filePath.c_str(), &_width, &_height, &_bpp, 4);
+    Upload();
+    TextureResidency::Get().Register(*this);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Texture::Texture(int width, int height, const unsigned char* rgba)
+    : _pixels(rgba, rgba + (size_t)width * (size_t)height * 4u),
+      _width(width),
+      _height(height),
+      _bpp(4)
+{
+    Upload();
+    TextureResidency::Get().Register(*this);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Texture::Texture(const std::string& path, int width, int height, const unsigned char* rgba)
+    : _filePath(path),
+      _width(width),
+      _height(height),
+      _bpp(4)
+{
+    Upload(rgba);
+    TextureResidency::Get().Register(*this);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Texture::~Texture()
+{
+    TextureResidency::Get().Unregister(*this);
+    Evict();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Texture::Bind(unsigned int slot, GLDebug::Caller caller) const
+{
+    TextureResidency::Get().Touch(*this);
+
+    GLCallFrom(caller, glActiveTexture(GL_TEXTURE0 + slot));
+    GLCallFrom(caller, glBindTexture(GL_TEXTURE_2D, _rendererID));
+    GLCapture::BindTexture(slot, _rendererID);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Texture::Unbind() const
+{
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void Texture::Upload(const unsigned char* decoded) const
+{
+    // file backed textures are decoded again instead of keeping a cpu copy
+    unsigned char* localBuffer = nullptr;
+    const unsigned char* pixels = decoded ? decoded : _pixels.data();
+    if ( !decoded && _pixels.empty() )
+    {
+        Texture* self = const_cast<Texture*>(this);
+        localBuffer = stbi_load(_filePath.c_str(), &self->_width, &self->_height, &self->_bpp, 4);
+        pixels = localBuffer;
+
+        if ( !localBuffer )
+            self->_width = self->_height = 0;
+    }
+
+    if ( !_alphaClassified && pixels )
+        ClassifyAlpha(pixels);
 
     glGenTextures(1, &_rendererID);
     glBindTexture(GL_TEXTURE_2D, _rendererID);
@@ -18,31 +92,51 @@ Texture::Texture(const std::string& filePath)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, _localBuffer);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    if ( _localBuffer )
-        stbi_image_free(_localBuffer);
+    ResourceMemory::Allocate(ResourceMemory::Category::Texture, GetSizeInBytes());
+
+    if ( localBuffer )
+        stbi_image_free(localBuffer);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-Texture::~Texture()
+void Texture::Evict() const
 {
+    if ( !IsResident() )
+        return;
+
     glDeleteTextures(1, &_rendererID);
-}
+    GLCapture::DeleteTexture(_rendererID);
+    _rendererID = 0;
 
-// -----------------------------------------------------------------------------
-// -----------------------------------------------------------------------------
-void Texture::Bind(unsigned int slot) const
-{
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, _rendererID);
+    ResourceMemory::Free(ResourceMemory::Category::Texture, GetSizeInBytes());
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void Texture::Unbind() const
+void Texture::ClassifyAlpha(const unsigned char* pixels) const
 {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    bool cutout = false;
+    size_t count = (size_t)_width * (size_t)_height;
+    for ( size_t ii = 0; ii < count; ++ii )
+    {
+        unsigned char alpha = pixels[ii * 4u + 3u];
+        if ( alpha == 255 )
+            continue;
+
+        if ( alpha != 0 )
+        {
+            _alphaUsage = AlphaUsage::Translucent;
+            _alphaClassified = true;
+            return;
+        }
+
+        cutout = true;
+    }
+
+    _alphaUsage = cutout ? AlphaUsage::Masked : AlphaUsage::Opaque;
+    _alphaClassified = true;
 }
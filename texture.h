@@ -2,6 +2,10 @@
 #define _texture_h_
 
 #include <string>
+#include <vector>
+#include <list>
+
+#include "gldebug.h"
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
@@ -9,10 +13,21 @@ class Texture
 {
 public:
 
+    // what the alpha channel holds, found when the pixels are first decoded
+    enum class AlphaUsage
+    {
+        Opaque,         // every texel is 255
+        Masked,         // only 0 and 255, cut out with an alpha test
+        Translucent     // anything in between, needs blending
+    };
+
     Texture( const std::string& path );
+    Texture( int width, int height, const unsigned char* rgba );
+    // file backed, the first upload uses pixels already decoded from path
+    Texture( const std::string& path, int width, int height, const unsigned char* rgba );
     ~Texture();
 
-    void Bind(unsigned int slot = 0) const;
+    void Bind(unsigned int slot = 0, GLDebug::Caller caller = {}) const;
     void Unbind() const;
 
     inline int GetWidth() const
@@ -25,14 +40,41 @@ public:
         return _height;
     }
 
+    inline bool IsResident() const
+    {
+        return _rendererID != 0;
+    }
+
+    inline AlphaUsage GetAlphaUsage() const
+    {
+        return _alphaUsage;
+    }
+
+    inline size_t GetSizeInBytes() const
+    {
+        return (size_t)_width * (size_t)_height * 4u;
+    }
+
 private:
 
-    unsigned int    _rendererID = 0;
-    std::string     _filePath;
-    unsigned char*  _localBuffer = nullptr;
-    int             _width = -1;
-    int             _height = -1;
-    int             _bpp = -1;
+    friend class TextureResidency;
+
+    // (re)creates the GL storage from the cpu copy or the file on disk
+    void Upload(const unsigned char* decoded = nullptr) const;
+    void Evict() const;
+    void ClassifyAlpha(const unsigned char* pixels) const;
+
+    mutable unsigned int    _rendererID = 0;
+    std::string             _filePath;
+    std::vector<unsigned char> _pixels;     // only kept for textures not backed by a file
+    int                     _width = -1;
+    int                     _height = -1;
+    int                     _bpp = -1;
+    mutable AlphaUsage      _alphaUsage = AlphaUsage::Opaque;
+    mutable bool            _alphaClassified = false;
+
+    mutable std::list<const Texture*>::iterator _lruEntry;
+    mutable unsigned int    _lastBoundFrame = 0;
 };
 
 #endif // _texture_h_
@@ -0,0 +1,105 @@
+#include "textureresidency.h"
+#include "texture.h"
+
+#include <imgui.h>
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TextureResidency& TextureResidency::Get()
+{
+    static TextureResidency instance;
+    return instance;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextureResidency::BeginFrame()
+{
+    ++_frame;
+    EnforceBudget();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextureResidency::Register(const Texture& texture)
+{
+    _lru.push_front(&texture);
+    texture._lruEntry = _lru.begin();
+    texture._lastBoundFrame = _frame;
+    _residentBytes += texture.GetSizeInBytes();
+    ++_uploads;
+
+    EnforceBudget();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextureResidency::Unregister(const Texture& texture)
+{
+    if ( texture.IsResident() )
+        _residentBytes -= texture.GetSizeInBytes();
+
+    _lru.erase(texture._lruEntry);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextureResidency::Touch(const Texture& texture)
+{
+    if ( !texture.IsResident() )
+    {
+        texture.Upload();
+        _residentBytes += texture.GetSizeInBytes();
+        ++_uploads;
+    }
+
+    texture._lastBoundFrame = _frame;
+    _lru.splice(_lru.begin(), _lru, texture._lruEntry);
+
+    EnforceBudget();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextureResidency::SetBudget(size_t bytes)
+{
+    _budget = bytes;
+    EnforceBudget();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextureResidency::EnforceBudget()
+{
+    // walk from the least recently bound end, never evicting a texture that
+    // was bound this frame as draws already issued may still reference it
+    auto it = _lru.end();
+    while ( _residentBytes > _budget && it != _lru.begin() )
+    {
+        --it;
+        const Texture* texture = *it;
+        if ( texture->_lastBoundFrame == _frame )
+            break;
+
+        if ( texture->IsResident() )
+        {
+            texture->Evict();
+            _residentBytes -= texture->GetSizeInBytes();
+            ++_evictions;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TextureResidency::OnImGuiRender()
+{
+    const float mb = 1.0f / (1024.0f * 1024.0f);
+
+    int budgetMB = (int)(_budget / (1024u * 1024u));
+    if ( ImGui::SliderInt("Texture Budget (MB)", &budgetMB, 8, 4096) )
+        SetBudget((size_t)budgetMB * 1024u * 1024u);
+
+    ImGui::Text("Resident: %.2f MB (%zu textures tracked)", _residentBytes * mb, _lru.size());
+    ImGui::Text("Uploads: %zu  Evictions: %zu", _uploads, _evictions);
+}
@@ -0,0 +1,65 @@
+#ifndef _textureresidency_h_
+#define _textureresidency_h_
+
+#include <list>
+#include <cstddef>
+
+class Texture;
+
+// -----------------------------------------------------------------------------
+// Keeps the GPU storage of textures within a budget. Textures are ordered by
+// the frame they were last bound in; when the budget is exceeded the least
+// recently bound ones drop their GL storage and are re-uploaded on next bind.
+// -----------------------------------------------------------------------------
+class TextureResidency
+{
+public:
+
+    static TextureResidency& Get();
+
+    void BeginFrame();
+
+    void Register(const Texture& texture);
+    void Unregister(const Texture& texture);
+
+    // makes sure the texture is resident, called on every bind
+    void Touch(const Texture& texture);
+
+    void SetBudget(size_t bytes);
+    inline size_t GetBudget() const
+    {
+        return _budget;
+    }
+
+    inline size_t GetResidentBytes() const
+    {
+        return _residentBytes;
+    }
+
+    inline size_t GetUploadCount() const
+    {
+        return _uploads;
+    }
+
+    inline size_t GetEvictionCount() const
+    {
+        return _evictions;
+    }
+
+    void OnImGuiRender();
+
+private:
+
+    TextureResidency() = default;
+
+    void EnforceBudget();
+
+    std::list<const Texture*>   _lru;           // most recently bound first
+    size_t                      _budget         = 256u * 1024u * 1024u;
+    size_t                      _residentBytes  = 0;
+    size_t                      _uploads        = 0;
+    size_t                      _evictions      = 0;
+    unsigned int                _frame          = 0;
+};
+
+#endif // _textureresidency_h_
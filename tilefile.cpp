@@ -0,0 +1,254 @@
+#include "tilefile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TileFileHeader::ComputeMipCount()
+{
+    mipCount = 1;
+    while ( GetTilesX(mipCount - 1) > 1 || GetTilesY(mipCount - 1) > 1 )
+        ++mipCount;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint64_t TileFileHeader::GetTileIndex(uint32_t mip, uint32_t x, uint32_t y) const
+{
+    uint64_t index = 0;
+    for ( uint32_t mm = 0; mm < mip; ++mm )
+        index += (uint64_t)GetTilesX(mm) * GetTilesY(mm);
+
+    return index + (uint64_t)y * GetTilesX(mip) + x;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+MappedTileFile::MappedTileFile()
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+MappedTileFile::~MappedTileFile()
+{
+    Close();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool MappedTileFile::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if ( _file == INVALID_HANDLE_VALUE )
+    {
+        _file = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(_file, &size);
+    _size = (size_t)size.QuadPart;
+
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if ( _mapping )
+        _data = (const unsigned char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    _fd = open(path.c_str(), O_RDONLY);
+    if ( _fd < 0 )
+        return false;
+
+    struct stat info;
+    if ( fstat(_fd, &info) == 0 )
+    {
+        _size = (size_t)info.st_size;
+        void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+        if ( data != MAP_FAILED )
+        {
+            _data = (const unsigned char*)data;
+            madvise(data, _size, MADV_RANDOM);
+        }
+    }
+#endif
+
+    if ( !_data || _size < sizeof(TileFileHeader) )
+    {
+        Close();
+        return false;
+    }
+
+    std::memcpy(&_header, _data, sizeof(_header));
+
+    // the tile layout divides by the content size and walks every level, so
+    // the fields it depends on are checked before it is used
+    bool valid = _header.magic == TileFileHeader::Magic &&
+                 _header.version == TileFileHeader::Version &&
+                 _header.tileSize <= TileFileHeader::MaxTileSize && (uint64_t)2 * _header.border < _header.tileSize &&
+                 _header.mipCount > 0 && _header.mipCount <= TileFileHeader::MaxMipCount;
+    if ( valid )
+    {
+        uint64_t tileCount = _header.GetTileIndex(_header.mipCount - 1, 0, 0) + 1;
+        valid = tileCount <= (_size - sizeof(TileFileHeader)) / _header.GetTileBytes();
+    }
+
+    if ( !valid )
+    {
+        std::cout << "Invalid tile file " << path << "\n";
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void MappedTileFile::Close()
+{
+#ifdef _WIN32
+    if ( _data )
+        UnmapViewOfFile(_data);
+    if ( _mapping )
+        CloseHandle(_mapping);
+    if ( _file )
+        CloseHandle(_file);
+    _mapping = _file = nullptr;
+#else
+    if ( _data )
+        munmap((void*)_data, _size);
+    if ( _fd >= 0 )
+        close(_fd);
+    _fd = -1;
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const TileFileHeader& MappedTileFile::GetHeader() const
+{
+    return _header;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool MappedTileFile::ReadTile(uint32_t mip, uint32_t x, uint32_t y, unsigned char* rgba) const
+{
+    if ( !_data || mip >= _header.mipCount || x >= _header.GetTilesX(mip) || y >= _header.GetTilesY(mip) )
+        return false;
+
+    size_t offset = sizeof(TileFileHeader) + _header.GetTileIndex(mip, x, y) * _header.GetTileBytes();
+    std::memcpy(rgba, _data + offset, _header.GetTileBytes());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+ProceduralTileSource::ProceduralTileSource(uint32_t width, uint32_t height)
+{
+    _header.width  = width;
+    _header.height = height;
+    _header.ComputeMipCount();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const TileFileHeader& ProceduralTileSource::GetHeader() const
+{
+    return _header;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool ProceduralTileSource::ReadTile(uint32_t mip, uint32_t x, uint32_t y, unsigned char* rgba) const
+{
+    const int content = (int)_header.GetContentSize();
+    const int border  = (int)_header.border;
+    const int size    = (int)_header.tileSize;
+    const int levelW  = (int)_header.GetLevelWidth(mip);
+    const int levelH  = (int)_header.GetLevelHeight(mip);
+
+    // tint per level so mip transitions are visible
+    static const unsigned char tints[8][3] = { {255, 255, 255}, {255, 200, 200}, {200, 255, 200}, {200, 200, 255},
+                                               {255, 255, 200}, {255, 200, 255}, {200, 255, 255}, {220, 220, 220} };
+    const unsigned char* tint = tints[mip % 8];
+
+    for ( int py = 0; py < size; ++py )
+    {
+        int ly = (int)y * content + py - border;
+        ly = ly < 0 ? 0 : (ly >= levelH ? levelH - 1 : ly);
+        uint32_t ty = (uint32_t)ly << mip;
+
+        for ( int px = 0; px < size; ++px )
+        {
+            int lx = (int)x * content + px - border;
+            lx = lx < 0 ? 0 : (lx >= levelW ? levelW - 1 : lx);
+            uint32_t tx = (uint32_t)lx << mip;
+
+            // level 0 texel coordinates: 1024 texel checker, 64 texel grid
+            // lines and a gradient across the whole image
+            bool checker = ((tx >> 10) ^ (ty >> 10)) & 1;
+            bool line    = mip < 6 && ((tx & 63) < (1u << mip) || (ty & 63) < (1u << mip));
+            unsigned char r = (unsigned char)(255u * tx / _header.width);
+            unsigned char g = (unsigned char)(255u * ty / _header.height);
+            unsigned char b = checker ? 200 : 60;
+            if ( line )
+                r = g = b = 20;
+
+            unsigned char* p = rgba + ((size_t)py * size + px) * 4;
+            p[0] = (unsigned char)(r * tint[0] / 255);
+            p[1] = (unsigned char)(g * tint[1] / 255);
+            p[2] = (unsigned char)(b * tint[2] / 255);
+            p[3] = 255;
+        }
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool WriteTileFile(const std::string& path, const TileSource& source)
+{
+    std::ofstream stream(path, std::ios::binary);
+    if ( !stream )
+        return false;
+
+    const TileFileHeader& header = source.GetHeader();
+    stream.write((const char*)&header, sizeof(header));
+
+    std::vector<unsigned char> tile(header.GetTileBytes());
+    for ( uint32_t mip = 0; mip < header.mipCount; ++mip )
+    {
+        for ( uint32_t y = 0; y < header.GetTilesY(mip); ++y )
+        {
+            for ( uint32_t x = 0; x < header.GetTilesX(mip); ++x )
+            {
+                if ( !source.ReadTile(mip, x, y, tile.data()) )
+                    return false;
+
+                stream.write((const char*)tile.data(), tile.size());
+            }
+        }
+    }
+
+    return (bool)stream;
+}
@@ -0,0 +1,136 @@
+#ifndef _tilefile_h_
+#define _tilefile_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Header of a cooked virtual texture. The file holds the full mip pyramid cut
+// into square RGBA8 tiles of tileSize pixels; each tile carries a border of
+// neighbouring texels so it can be filtered in isolation. Tiles are stored
+// level after level, row major within a level.
+// -----------------------------------------------------------------------------
+struct TileFileHeader
+{
+    static constexpr uint32_t Magic   = 0x58455456; // "VTEX"
+    static constexpr uint32_t Version = 1;
+
+    // a 32 bit size has at most 32 levels
+    static constexpr uint32_t MaxTileSize = 4096;
+    static constexpr uint32_t MaxMipCount = 32;
+
+    uint32_t    magic       = Magic;
+    uint32_t    version     = Version;
+    uint32_t    width       = 0;
+    uint32_t    height      = 0;
+    uint32_t    tileSize    = 128;
+    uint32_t    border      = 4;
+    uint32_t    mipCount    = 0;
+    uint32_t    reserved    = 0;
+
+    inline uint32_t GetContentSize() const
+    {
+        return tileSize - 2 * border;
+    }
+
+    inline uint32_t GetLevelWidth(uint32_t mip) const
+    {
+        return width >> mip ? width >> mip : 1;
+    }
+
+    inline uint32_t GetLevelHeight(uint32_t mip) const
+    {
+        return height >> mip ? height >> mip : 1;
+    }
+
+    inline uint32_t GetTilesX(uint32_t mip) const
+    {
+        return (GetLevelWidth(mip) + GetContentSize() - 1) / GetContentSize();
+    }
+
+    inline uint32_t GetTilesY(uint32_t mip) const
+    {
+        return (GetLevelHeight(mip) + GetContentSize() - 1) / GetContentSize();
+    }
+
+    inline size_t GetTileBytes() const
+    {
+        return (size_t)tileSize * tileSize * 4u;
+    }
+
+    // fills in mipCount so that the last level fits in a single tile
+    void ComputeMipCount();
+
+    // index of a tile counted over all levels
+    uint64_t GetTileIndex(uint32_t mip, uint32_t x, uint32_t y) const;
+};
+
+// -----------------------------------------------------------------------------
+// Something that can produce the tiles of a virtual texture.
+// -----------------------------------------------------------------------------
+class TileSource
+{
+public:
+
+    virtual ~TileSource() {}
+
+    virtual const TileFileHeader& GetHeader() const = 0;
+
+    // writes tileSize * tileSize RGBA8 pixels, may be called from any thread
+    virtual bool ReadTile(uint32_t mip, uint32_t x, uint32_t y, unsigned char* rgba) const = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Cooked tile file mapped into memory, reading a tile is a copy out of the
+// mapping and the OS pages data in on demand.
+// -----------------------------------------------------------------------------
+class MappedTileFile : public TileSource
+{
+public:
+
+    MappedTileFile();
+    ~MappedTileFile();
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const TileFileHeader& GetHeader() const override;
+    bool ReadTile(uint32_t mip, uint32_t x, uint32_t y, unsigned char* rgba) const override;
+
+private:
+
+    TileFileHeader          _header;
+    const unsigned char*    _data = nullptr;
+    size_t                  _size = 0;
+
+#ifdef _WIN32
+    void*                   _file    = nullptr;
+    void*                   _mapping = nullptr;
+#else
+    int                     _fd      = -1;
+#endif
+};
+
+// -----------------------------------------------------------------------------
+// Endless test pattern of any size, used when no cooked file is around and by
+// the cooker to produce large test files.
+// -----------------------------------------------------------------------------
+class ProceduralTileSource : public TileSource
+{
+public:
+
+    ProceduralTileSource(uint32_t width, uint32_t height);
+
+    const TileFileHeader& GetHeader() const override;
+    bool ReadTile(uint32_t mip, uint32_t x, uint32_t y, unsigned char* rgba) const override;
+
+private:
+
+    TileFileHeader  _header;
+};
+
+// writes every tile of source to path
+bool WriteTileFile(const std::string& path, const TileSource& source);
+
+#endif // _tilefile_h_
@@ -0,0 +1,267 @@
+#include "transform.h"
+#include "transformkernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define TRANSFORM_X86
+    #include <emmintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t TransformSoA::Add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+    size_t index = GetCount();
+    px.push_back(position.x); py.push_back(position.y); pz.push_back(position.z);
+    qx.push_back(rotation.x); qy.push_back(rotation.y); qz.push_back(rotation.z); qw.push_back(rotation.w);
+    sx.push_back(scale.x); sy.push_back(scale.y); sz.push_back(scale.z);
+    return index;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TransformSoA::Set(size_t index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+    px[index] = position.x; py[index] = position.y; pz[index] = position.z;
+    qx[index] = rotation.x; qy[index] = rotation.y; qz[index] = rotation.z; qw[index] = rotation.w;
+    sx[index] = scale.x; sy[index] = scale.y; sz[index] = scale.z;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TransformSoA::Reserve(size_t count)
+{
+    for ( auto* component : { &px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz } )
+        component->reserve(count);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void TransformSoA::Clear()
+{
+    for ( auto* component : { &px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz } )
+        component->clear();
+}
+
+namespace TransformKernel
+{
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+struct ScalarOps
+{
+    using Vec = float;
+    static constexpr size_t Width = 1;
+
+    static inline Vec Load(const float* p)              { return *p; }
+    static inline Vec Set1(float f)                     { return f; }
+    static inline Vec Add(Vec a, Vec b)                 { return a + b; }
+    static inline Vec Sub(Vec a, Vec b)                 { return a - b; }
+    static inline Vec Mul(Vec a, Vec b)                 { return a * b; }
+    static inline Vec MulAdd(Vec a, Vec b, Vec c)       { return a * b + c; }
+
+    static inline void Store16(const Vec o[16], float* out)
+    {
+        for ( int ii = 0; ii < 16; ++ii )
+            out[ii] = o[ii];
+    }
+};
+
+#ifdef TRANSFORM_X86
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+struct SSEOps
+{
+    using Vec = __m128;
+    static constexpr size_t Width = 4;
+
+    static inline Vec Load(const float* p)              { return _mm_loadu_ps(p); }
+    static inline Vec Set1(float f)                     { return _mm_set1_ps(f); }
+    static inline Vec Add(Vec a, Vec b)                 { return _mm_add_ps(a, b); }
+    static inline Vec Sub(Vec a, Vec b)                 { return _mm_sub_ps(a, b); }
+    static inline Vec Mul(Vec a, Vec b)                 { return _mm_mul_ps(a, b); }
+    static inline Vec MulAdd(Vec a, Vec b, Vec c)       { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+    // lanes hold objects, transpose each group of four values back to the
+    // per object layout
+    static inline void Store16(const Vec o[16], float* out)
+    {
+        for ( int gg = 0; gg < 4; ++gg )
+        {
+            Vec r0 = o[gg * 4 + 0], r1 = o[gg * 4 + 1], r2 = o[gg * 4 + 2], r3 = o[gg * 4 + 3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(out + 0 * 16 + gg * 4, r0);
+            _mm_storeu_ps(out + 1 * 16 + gg * 4, r1);
+            _mm_storeu_ps(out + 2 * 16 + gg * 4, r2);
+            _mm_storeu_ps(out + 3 * 16 + gg * 4, r3);
+        }
+    }
+};
+
+#endif
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool CpuSupportsAVX2()
+{
+#if defined(TRANSFORM_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(TRANSFORM_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool fma     = (info[2] & (1 << 12)) != 0;
+    if ( !osxsave || !fma || (_xgetbv(0) & 0x6) != 0x6 )
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Kernel SelectKernel()
+{
+    if ( IsSupported(Kernel::AVX2) )
+        return Kernel::AVX2;
+
+    if ( IsSupported(Kernel::SSE) )
+        return Kernel::SSE;
+
+    return Kernel::Scalar;
+}
+
+Kernel s_kernel = SelectKernel();
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+TransformArrays GetArrays(const TransformSoA& t)
+{
+    return { t.px.data(), t.py.data(), t.pz.data(),
+             t.qx.data(), t.qy.data(), t.qz.data(), t.qw.data(),
+             t.sx.data(), t.sy.data(), t.sz.data() };
+}
+
+}
+
+#ifdef TRANSFORM_X86
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t ClipMatricesSSE(const TransformArrays& t, const float* viewProj, size_t first, size_t count, float* out)
+{
+    return ClipMatricesBatched<SSEOps>(t, viewProj, first, count, out);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t QuadCornersSSE(const TransformArrays& t, const float* viewProj, float halfX, float halfY,
+                      size_t first, size_t count, float* out)
+{
+    return QuadCornersBatched<SSEOps>(t, viewProj, halfX, halfY, first, count, out);
+}
+
+#else
+
+size_t ClipMatricesSSE(const TransformArrays&, const float*, size_t, size_t, float*) { return 0; }
+size_t QuadCornersSSE(const TransformArrays&, const float*, float, float, size_t, size_t, float*) { return 0; }
+
+#endif
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+Kernel GetKernel()
+{
+    return s_kernel;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void SetKernel(Kernel kernel)
+{
+    s_kernel = IsSupported(kernel) ? kernel : SelectKernel();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool IsSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef TRANSFORM_X86
+        case Kernel::SSE:   return true;
+#endif
+        case Kernel::AVX2:  return IsAVX2Compiled() && CpuSupportsAVX2();
+        case Kernel::Scalar: return true;
+        default:            break;
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+const char* GetName(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::Scalar:    return "Scalar";
+        case Kernel::SSE:       return "SSE";
+        case Kernel::AVX2:      return "AVX2";
+    }
+
+    return "Unknown";
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ComputeClipMatrices(const TransformSoA& transforms, const glm::mat4& viewProj,
+                         size_t first, size_t count, glm::mat4* out)
+{
+    TransformArrays arrays = GetArrays(transforms);
+    const float* vp = &viewProj[0][0];
+    float* o = reinterpret_cast<float*>(out);
+
+    size_t done = 0;
+    switch (s_kernel)
+    {
+        case Kernel::AVX2:  done = ClipMatricesAVX2(arrays, vp, first, count, o); break;
+        case Kernel::SSE:   done = ClipMatricesSSE(arrays, vp, first, count, o); break;
+        default:            break;
+    }
+
+    // remainder that does not fill a whole batch
+    ClipMatricesBatched<ScalarOps>(arrays, vp, first + done, count - done, o + done * 16);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void ComputeQuadCorners(const TransformSoA& transforms, const glm::mat4& viewProj,
+                        const glm::vec2& halfExtent, size_t first, size_t count, glm::vec4* out)
+{
+    TransformArrays arrays = GetArrays(transforms);
+    const float* vp = &viewProj[0][0];
+    float* o = reinterpret_cast<float*>(out);
+
+    size_t done = 0;
+    switch (s_kernel)
+    {
+        case Kernel::AVX2:  done = QuadCornersAVX2(arrays, vp, halfExtent.x, halfExtent.y, first, count, o); break;
+        case Kernel::SSE:   done = QuadCornersSSE(arrays, vp, halfExtent.x, halfExtent.y, first, count, o); break;
+        default:            break;
+    }
+
+    QuadCornersBatched<ScalarOps>(arrays, vp, halfExtent.x, halfExtent.y, first + done, count - done, o + done * 16);
+}
+
+}
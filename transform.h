@@ -0,0 +1,59 @@
+#ifndef _transform_h_
+#define _transform_h_
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Object transforms stored as one array per component so batches of objects
+// can be loaded straight into SIMD registers.
+// -----------------------------------------------------------------------------
+struct TransformSoA
+{
+    size_t Add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    void Set(size_t index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    void Reserve(size_t count);
+    void Clear();
+
+    inline size_t GetCount() const
+    {
+        return px.size();
+    }
+
+    std::vector<float>  px, py, pz;
+    std::vector<float>  qx, qy, qz, qw;
+    std::vector<float>  sx, sy, sz;
+};
+
+// -----------------------------------------------------------------------------
+// Batched clip space transform kernels. The best kernel the cpu supports is
+// picked on first use, SetKernel allows forcing one for comparisons.
+// -----------------------------------------------------------------------------
+namespace TransformKernel
+{
+    enum class Kernel
+    {
+        Scalar = 0,
+        SSE,
+        AVX2
+    };
+
+    Kernel GetKernel();
+    void SetKernel(Kernel kernel);
+    bool IsSupported(Kernel kernel);
+    const char* GetName(Kernel kernel);
+
+    // out[i] = viewProj * T(p) * R(q) * S(s) for objects [first, first + count)
+    void ComputeClipMatrices(const TransformSoA& transforms, const glm::mat4& viewProj,
+                             size_t first, size_t count, glm::mat4* out);
+
+    // clip space corners of a quad of the given half extent centred on each
+    // object, four corners per object in counter clockwise order
+    void ComputeQuadCorners(const TransformSoA& transforms, const glm::mat4& viewProj,
+                            const glm::vec2& halfExtent, size_t first, size_t count, glm::vec4* out);
+}
+
+#endif // _transform_h_
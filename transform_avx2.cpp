@@ -0,0 +1,108 @@
+// Compiled with AVX2 and FMA enabled, only called after TransformKernel has
+// checked the cpu supports them. Only raw arrays come in, so nothing from std
+// or glm is instantiated with these flags.
+#include "transformkernel.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+namespace TransformKernel
+{
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+struct AVX2Ops
+{
+    using Vec = __m256;
+    static constexpr size_t Width = 8;
+
+    static inline Vec Load(const float* p)              { return _mm256_loadu_ps(p); }
+    static inline Vec Set1(float f)                     { return _mm256_set1_ps(f); }
+    static inline Vec Add(Vec a, Vec b)                 { return _mm256_add_ps(a, b); }
+    static inline Vec Sub(Vec a, Vec b)                 { return _mm256_sub_ps(a, b); }
+    static inline Vec Mul(Vec a, Vec b)                 { return _mm256_mul_ps(a, b); }
+    static inline Vec MulAdd(Vec a, Vec b, Vec c)       { return _mm256_fmadd_ps(a, b, c); }
+
+    // 8x8 transpose of values [first, first + 8) so each row holds the
+    // values of one object
+    static inline void Transpose8(const Vec* in, Vec* r)
+    {
+        Vec t0 = _mm256_unpacklo_ps(in[0], in[1]), t1 = _mm256_unpackhi_ps(in[0], in[1]);
+        Vec t2 = _mm256_unpacklo_ps(in[2], in[3]), t3 = _mm256_unpackhi_ps(in[2], in[3]);
+        Vec t4 = _mm256_unpacklo_ps(in[4], in[5]), t5 = _mm256_unpackhi_ps(in[4], in[5]);
+        Vec t6 = _mm256_unpacklo_ps(in[6], in[7]), t7 = _mm256_unpackhi_ps(in[6], in[7]);
+
+        Vec s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        Vec s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        Vec s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        Vec s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+        r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+    }
+
+    static inline void Store16(const Vec o[16], float* out)
+    {
+        Vec r[8];
+        Transpose8(o, r);
+        for ( int ii = 0; ii < 8; ++ii )
+            _mm256_storeu_ps(out + ii * 16, r[ii]);
+
+        Transpose8(o + 8, r);
+        for ( int ii = 0; ii < 8; ++ii )
+            _mm256_storeu_ps(out + ii * 16 + 8, r[ii]);
+    }
+};
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool IsAVX2Compiled()
+{
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t ClipMatricesAVX2(const TransformArrays& t, const float* viewProj, size_t first, size_t count, float* out)
+{
+    return ClipMatricesBatched<AVX2Ops>(t, viewProj, first, count, out);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t QuadCornersAVX2(const TransformArrays& t, const float* viewProj, float halfX, float halfY,
+                       size_t first, size_t count, float* out)
+{
+    return QuadCornersBatched<AVX2Ops>(t, viewProj, halfX, halfY, first, count, out);
+}
+
+}
+
+#else
+
+namespace TransformKernel
+{
+
+bool IsAVX2Compiled() { return false; }
+size_t ClipMatricesAVX2(const TransformArrays&, const float*, size_t, size_t, float*) { return 0; }
+size_t QuadCornersAVX2(const TransformArrays&, const float*, float, float, size_t, size_t, float*) { return 0; }
+
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef _transformkernel_h_
+#define _transformkernel_h_
+
+// -----------------------------------------------------------------------------
+// Kernel bodies shared by the scalar, SSE and AVX2 translation units. Ops
+// provides the vector type and its arithmetic; each unit instantiates these
+// with its own Ops so the code is compiled for the right instruction set.
+//
+// Everything here works on raw float arrays. The AVX2 unit is compiled with
+// -mavx2 -mfma, and any std or glm inline function it instantiated could be
+// the copy the linker keeps for the whole program, so it must not use them.
+// -----------------------------------------------------------------------------
+
+#include <cstddef>
+
+namespace TransformKernel
+{
+
+// component arrays of a TransformSoA
+struct TransformArrays
+{
+    const float*    px;
+    const float*    py;
+    const float*    pz;
+    const float*    qx;
+    const float*    qy;
+    const float*    qz;
+    const float*    qw;
+    const float*    sx;
+    const float*    sy;
+    const float*    sz;
+};
+
+// -----------------------------------------------------------------------------
+// clip space columns 0, 1, 2, 3 of viewProj * T * R * S, 16 values row major
+// per column (o[c * 4 + r])
+// -----------------------------------------------------------------------------
+template <typename Ops>
+inline void ComputeClipColumns(const TransformArrays& t, const typename Ops::Vec vp[16],
+                               size_t ii, typename Ops::Vec o[16])
+{
+    using Vec = typename Ops::Vec;
+
+    Vec qx = Ops::Load(t.qx + ii), qy = Ops::Load(t.qy + ii);
+    Vec qz = Ops::Load(t.qz + ii), qw = Ops::Load(t.qw + ii);
+    Vec two = Ops::Set1(2.0f);
+
+    Vec xx = Ops::Mul(qx, qx), yy = Ops::Mul(qy, qy), zz = Ops::Mul(qz, qz);
+    Vec xy = Ops::Mul(qx, qy), xz = Ops::Mul(qx, qz), yz = Ops::Mul(qy, qz);
+    Vec wx = Ops::Mul(qw, qx), wy = Ops::Mul(qw, qy), wz = Ops::Mul(qw, qz);
+
+    Vec sx = Ops::Mul(Ops::Load(t.sx + ii), two);
+    Vec sy = Ops::Mul(Ops::Load(t.sy + ii), two);
+    Vec sz = Ops::Mul(Ops::Load(t.sz + ii), two);
+    Vec hsx = Ops::Load(t.sx + ii), hsy = Ops::Load(t.sy + ii), hsz = Ops::Load(t.sz + ii);
+
+    // world columns, rotation scaled per axis
+    Vec w[3][3];
+    w[0][0] = Ops::Sub(hsx, Ops::Mul(Ops::Add(yy, zz), sx));
+    w[0][1] = Ops::Mul(Ops::Add(xy, wz), sx);
+    w[0][2] = Ops::Mul(Ops::Sub(xz, wy), sx);
+    w[1][0] = Ops::Mul(Ops::Sub(xy, wz), sy);
+    w[1][1] = Ops::Sub(hsy, Ops::Mul(Ops::Add(xx, zz), sy));
+    w[1][2] = Ops::Mul(Ops::Add(yz, wx), sy);
+    w[2][0] = Ops::Mul(Ops::Add(xz, wy), sz);
+    w[2][1] = Ops::Mul(Ops::Sub(yz, wx), sz);
+    w[2][2] = Ops::Sub(hsz, Ops::Mul(Ops::Add(xx, yy), sz));
+
+    for ( int cc = 0; cc < 3; ++cc )
+    {
+        for ( int rr = 0; rr < 4; ++rr )
+        {
+            Vec v = Ops::Mul(vp[rr], w[cc][0]);
+            v = Ops::MulAdd(vp[4 + rr], w[cc][1], v);
+            o[cc * 4 + rr] = Ops::MulAdd(vp[8 + rr], w[cc][2], v);
+        }
+    }
+
+    Vec px = Ops::Load(t.px + ii), py = Ops::Load(t.py + ii), pz = Ops::Load(t.pz + ii);
+    for ( int rr = 0; rr < 4; ++rr )
+    {
+        Vec v = Ops::MulAdd(vp[rr], px, vp[12 + rr]);
+        v = Ops::MulAdd(vp[4 + rr], py, v);
+        o[12 + rr] = Ops::MulAdd(vp[8 + rr], pz, v);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// processes whole batches of Ops::Width objects, returns how many were done;
+// viewProj and every output matrix are 16 floats, column major
+// -----------------------------------------------------------------------------
+template <typename Ops>
+size_t ClipMatricesBatched(const TransformArrays& t, const float* viewProj,
+                           size_t first, size_t count, float* out)
+{
+    using Vec = typename Ops::Vec;
+
+    Vec vp[16];
+    for ( int ii = 0; ii < 16; ++ii )
+        vp[ii] = Ops::Set1(viewProj[ii]);
+
+    size_t done = 0;
+    for ( ; done + Ops::Width <= count; done += Ops::Width )
+    {
+        Vec o[16];
+        ComputeClipColumns<Ops>(t, vp, first + done, o);
+        Ops::Store16(o, out + done * 16);
+    }
+
+    return done;
+}
+
+// four corners of 4 floats per object
+// -----------------------------------------------------------------------------
+template <typename Ops>
+size_t QuadCornersBatched(const TransformArrays& t, const float* viewProj, float halfX, float halfY,
+                          size_t first, size_t count, float* out)
+{
+    using Vec = typename Ops::Vec;
+
+    Vec vp[16];
+    for ( int ii = 0; ii < 16; ++ii )
+        vp[ii] = Ops::Set1(viewProj[ii]);
+
+    Vec hx = Ops::Set1(halfX), hy = Ops::Set1(halfY);
+
+    size_t done = 0;
+    for ( ; done + Ops::Width <= count; done += Ops::Width )
+    {
+        Vec c[16];
+        ComputeClipColumns<Ops>(t, vp, first + done, c);
+
+        // corner = c3 -/+ c0 * hx -/+ c1 * hy
+        Vec o[16];
+        for ( int rr = 0; rr < 4; ++rr )
+        {
+            Vec a = Ops::Mul(c[rr], hx);
+            Vec b = Ops::Mul(c[4 + rr], hy);
+            Vec lo = Ops::Sub(c[12 + rr], b);
+            Vec hi = Ops::Add(c[12 + rr], b);
+            o[0 + rr]  = Ops::Sub(lo, a);
+            o[4 + rr]  = Ops::Add(lo, a);
+            o[8 + rr]  = Ops::Add(hi, a);
+            o[12 + rr] = Ops::Sub(hi, a);
+        }
+
+        Ops::Store16(o, out + done * 16);
+    }
+
+    return done;
+}
+
+// entry points of the instruction set specific units, the AVX2 ones return 0
+// when the unit was built without AVX2 support
+bool IsAVX2Compiled();
+size_t ClipMatricesSSE(const TransformArrays& t, const float* viewProj, size_t first, size_t count, float* out);
+size_t ClipMatricesAVX2(const TransformArrays& t, const float* viewProj, size_t first, size_t count, float* out);
+size_t QuadCornersSSE(const TransformArrays& t, const float* viewProj, float halfX, float halfY,
+                      size_t first, size_t count, float* out);
+size_t QuadCornersAVX2(const TransformArrays& t, const float* viewProj, float halfX, float halfY,
+                       size_t first, size_t count, float* out);
+
+}
+
+#endif // _transformkernel_h_
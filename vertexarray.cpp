@@ -1,6 +1,7 @@
 #include "vertexarray.h"
 #include "vertexbuffer.h"
 #include "vertexbufferlayout.h"
+#include "glcapture.h"
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
@@ -14,13 +15,15 @@ VertexArray::VertexArray()
 VertexArray::~VertexArray()
 {
     glDeleteVertexArrays(1, &_rendererID);
+    GLCapture::DeleteVertexArray(_rendererID);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void VertexArray::Bind() const
+void VertexArray::Bind(GLDebug::Caller caller) const
 {
-    glBindVertexArray(_rendererID);
+    GLCallFrom(caller, glBindVertexArray(_rendererID));
+    GLCapture::BindVertexArray(_rendererID, _attributes.data(), (unsigned int)_attributes.size());
 }
 
 // -----------------------------------------------------------------------------
@@ -32,7 +35,8 @@ void VertexArray::Unbind() const
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout &layout)
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout &layout,
+                            unsigned int firstAttribute, unsigned int divisor)
 {
     Bind();
     vb.Bind();
@@ -41,9 +45,24 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout &la
     for ( unsigned int ii = 0; ii < elements.size(); ++ii )
     {
         const auto& element = elements[ii];
-        glEnableVertexAttribArray(ii);
-        glVertexAttribPointer(ii, element.count, element.type, element.normalized,
-                layout.GetStride(), (const void*)offset);
+        unsigned int index = firstAttribute + ii;
+        glEnableVertexAttribArray(index);
+
+        // unnormalized integers stay integers in the shader
+        bool integer = element.type == GL_UNSIGNED_INT && !element.normalized;
+        _attributes.push_back({ vb.GetRendererID(), index, (int32_t)element.count, element.type, layout.GetStride(),
+                                offset, divisor, (uint8_t)element.normalized, (uint8_t)integer, {} });
+
+        if ( integer )
+            glVertexAttribIPointer(index, element.count, element.type,
+                    layout.GetStride(), (const void*)(uintptr_t)offset);
+        else
+            glVertexAttribPointer(index, element.count, element.type, element.normalized,
+                    layout.GetStride(), (const void*)(uintptr_t)offset);
+
+        if ( divisor )
+            glVertexAttribDivisor(index, divisor);
+
         offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
     }
 }
@@ -1,6 +1,11 @@
 #ifndef _vertexarray_h_
 #define _vertexarray_h_
 
+#include "gltrace.h"
+#include "gldebug.h"
+
+#include <vector>
+
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 class VertexBuffer;
@@ -15,13 +20,18 @@ public:
     VertexArray();
     ~VertexArray();
 
-    void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+    // attributes of the layout are assigned consecutive locations starting at
+    // firstAttribute, a non zero divisor makes them per instance
+    void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout,
+                   unsigned int firstAttribute = 0, unsigned int divisor = 0);
 
-    void Bind() const;
+    void Bind(GLDebug::Caller caller = {}) const;
     void Unbind() const;
 private:
 
     unsigned int _rendererID = 0;
+    // kept so a GL capture can recreate the array
+    std::vector<TraceVertexAttribute> _attributes;
 };
 
 #endif // _vertexarray_h_
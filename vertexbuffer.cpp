@@ -1,13 +1,26 @@
 #include "renderer.h"
 #include "vertexbuffer.h"
+#include "resourcememory.h"
+#include "glcapture.h"
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 VertexBuffer::VertexBuffer( const void* data, unsigned int size )
+    : VertexBuffer(data, size, GL_STATIC_DRAW)
+{
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+VertexBuffer::VertexBuffer( const void* data, unsigned int size, unsigned int usage )
+    : _size(size),
+      _usage(usage)
 {
     glGenBuffers(1, &_rendererID);
     glBindBuffer(GL_ARRAY_BUFFER, _rendererID);
-    glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, size, data, usage);
+
+    ResourceMemory::Allocate(ResourceMemory::Category::VertexBuffer, _size);
 }
 
 // -----------------------------------------------------------------------------
@@ -15,13 +28,17 @@ VertexBuffer::VertexBuffer( const void* data, unsigned int size )
 VertexBuffer::~VertexBuffer()
 {
     glDeleteBuffers(1, &_rendererID);
+    GLCapture::DeleteBuffer(_rendererID);
+
+    ResourceMemory::Free(ResourceMemory::Category::VertexBuffer, _size);
 }
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
-void VertexBuffer::Bind() const
+void VertexBuffer::Bind(GLDebug::Caller caller) const
 {
-    glBindBuffer(GL_ARRAY_BUFFER, _rendererID);
+    GLCallFrom(caller, glBindBuffer(GL_ARRAY_BUFFER, _rendererID));
+    GLCapture::BindBuffer(GL_ARRAY_BUFFER, _rendererID);
 }
 
 // -----------------------------------------------------------------------------
@@ -30,3 +47,25 @@ void VertexBuffer::Unbind() const
 {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VertexBuffer::Stream( const void* data, unsigned int size, GLDebug::Caller caller )
+{
+    GLCallFrom(caller, glBindBuffer(GL_ARRAY_BUFFER, _rendererID));
+    GLCapture::BindBuffer(GL_ARRAY_BUFFER, _rendererID);
+    GLCallFrom(caller, glBufferData(GL_ARRAY_BUFFER, _size, nullptr, _usage));
+    GLCapture::BufferData(GL_ARRAY_BUFFER, _size, _usage);
+    GLCallFrom(caller, glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+    GLCapture::BufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VertexBuffer::SetSubData( unsigned int offset, unsigned int size, const void* data, GLDebug::Caller caller )
+{
+    GLCallFrom(caller, glBindBuffer(GL_ARRAY_BUFFER, _rendererID));
+    GLCapture::BindBuffer(GL_ARRAY_BUFFER, _rendererID);
+    GLCallFrom(caller, glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+    GLCapture::BufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
@@ -1,6 +1,8 @@
 #ifndef _vertexbuffer_h_
 #define _vertexbuffer_h_
 
+#include "gldebug.h"
+
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 class VertexBuffer
@@ -8,14 +10,34 @@ class VertexBuffer
 public:
 
     VertexBuffer( const void* data, unsigned int size );
+    VertexBuffer( const void* data, unsigned int size, unsigned int usage );
     ~VertexBuffer();
 
-    void Bind() const;
+    void Bind(GLDebug::Caller caller = {}) const;
     void Unbind() const;
 
+    // orphans the storage so the driver does not have to wait for draws still
+    // reading the previous contents, then uploads size bytes from the start
+    void Stream( const void* data, unsigned int size, GLDebug::Caller caller = {} );
+
+    // rewrites size bytes at offset in place
+    void SetSubData( unsigned int offset, unsigned int size, const void* data, GLDebug::Caller caller = {} );
+
+    inline unsigned int GetSize() const
+    {
+        return _size;
+    }
+
+    inline unsigned int GetRendererID() const
+    {
+        return _rendererID;
+    }
+
 private:
 
     unsigned int    _rendererID = 0;
+    unsigned int    _size       = 0;
+    unsigned int    _usage      = 0;
 };
 
 #endif // _vertexbuffer_h_
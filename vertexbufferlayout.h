@@ -2,7 +2,7 @@
 #define _vertexbufferlayout_h_
 
 #include "renderer.h"
-#include <vector>
+#include "allocators.h"
 #include <cassert>
 
 // -----------------------------------------------------------------------------
@@ -19,6 +19,7 @@ struct VertexBufferElement
         {
             case GL_FLOAT: return 4;
             case GL_UNSIGNED_INT: return 4;
+            case GL_UNSIGNED_SHORT: return 2;
             case GL_UNSIGNED_BYTE: return 1;
         }
         assert(false);
@@ -40,9 +41,9 @@ public:
         // static_assert(false);
     }
 
-    inline const std::vector<VertexBufferElement>& GetElements() const
+    inline ArrayView<VertexBufferElement> GetElements() const
     {
-        return _elements;
+        return ArrayView<VertexBufferElement>(_elements, _count);
     }
 
     inline unsigned int GetStride() const
@@ -52,7 +53,18 @@ public:
 
 private:
 
-    std::vector<VertexBufferElement>    _elements;
+    void Append(const VertexBufferElement& element)
+    {
+        assert(_count < MaxElements);
+        _elements[_count++] = element;
+        _stride += element.count * VertexBufferElement::GetSizeOfType(element.type);
+    }
+
+    // GL guarantees at least 16 vertex attributes
+    static constexpr unsigned int       MaxElements = 16;
+
+    VertexBufferElement                 _elements[MaxElements];
+    unsigned int                        _count  = 0;
     unsigned int                        _stride = 0;
 
 };
@@ -62,8 +74,7 @@ private:
 template<>
 inline void VertexBufferLayout::Push<float>(unsigned int count)
 {
-    _elements.push_back({ GL_FLOAT, count, GL_FALSE });
-    _stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+    Append({ GL_FLOAT, count, GL_FALSE });
 }
 
 // -----------------------------------------------------------------------------
@@ -71,8 +82,15 @@ inline void VertexBufferLayout::Push<float>(unsigned int count)
 template<>
 inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
 {
-    _elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-    _stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+    Append({ GL_UNSIGNED_INT, count, GL_FALSE });
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count)
+{
+    Append({ GL_UNSIGNED_SHORT, count, GL_TRUE });
 }
 
 // -----------------------------------------------------------------------------
@@ -80,8 +98,7 @@ inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
 template<>
 inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
 {
-    _elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-    _stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+    Append({ GL_UNSIGNED_BYTE, count, GL_TRUE });
 }
 
 #endif // _vertexbufferlayout_h_
@@ -0,0 +1,436 @@
+#include "renderer.h"
+#include "virtualtexture.h"
+#include "resourcememory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+uint32_t NextPowerOfTwo(uint32_t value)
+{
+    uint32_t result = 1;
+    while ( result < value )
+        result <<= 1;
+
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+inline uint32_t PackEntry(uint32_t slotX, uint32_t slotY, uint32_t mip)
+{
+    return slotX | (slotY << 8) | (mip << 16) | (255u << 24);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+inline uint32_t GetEntryMip(uint32_t entry)
+{
+    return (entry >> 16) & 255u;
+}
+
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+VirtualTexture::VirtualTexture(std::unique_ptr<TileSource> source, unsigned int cacheTilesPerSide)
+    : _source(std::move(source)),
+      _header(_source->GetHeader()),
+      _cacheTiles(std::min(cacheTilesPerSide, 255u))
+{
+    // physical cache, a grid of tile sized slots
+    unsigned int cacheSize = _cacheTiles * _header.tileSize;
+    glGenTextures(1, &_physicalID);
+    glBindTexture(GL_TEXTURE_2D, _physicalID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, cacheSize, cacheSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    _slots.resize(_cacheTiles * _cacheTiles);
+
+    // indirection, one texel per tile on a power of two grid so tiles of
+    // neighbouring levels nest exactly
+    _indirectionW = NextPowerOfTwo(_header.GetTilesX(0));
+    _indirectionH = NextPowerOfTwo(_header.GetTilesY(0));
+    _indirection.resize(_header.mipCount);
+    _dirty.resize(_header.mipCount);
+
+    glGenTextures(1, &_indirectionID);
+    glBindTexture(GL_TEXTURE_2D, _indirectionID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _header.mipCount - 1);
+    for ( uint32_t level = 0; level < _header.mipCount; ++level )
+    {
+        uint32_t w = std::max(1u, _indirectionW >> level), h = std::max(1u, _indirectionH >> level);
+        _indirection[level].assign((size_t)w * h, 0u);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    ResourceMemory::Allocate(ResourceMemory::Category::Texture, GetGpuBytes());
+
+    // the single tile of the last level is always resident so every part of
+    // the image has something to fall back to
+    std::vector<unsigned char> pixels(_header.GetTileBytes());
+    if ( _source->ReadTile(_header.mipCount - 1, 0, 0, pixels.data()) )
+        Upload(MakeKey(_header.mipCount - 1, 0, 0), pixels.data(), true);
+    UploadIndirection();
+
+    _worker = std::thread(&VirtualTexture::WorkerMain, this);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+VirtualTexture::~VirtualTexture()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wake.notify_all();
+    _worker.join();
+
+    ResourceMemory::Free(ResourceMemory::Category::Texture, GetGpuBytes());
+    glDeleteTextures(1, &_physicalID);
+    glDeleteTextures(1, &_indirectionID);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+size_t VirtualTexture::GetGpuBytes() const
+{
+    size_t cacheSize = (size_t)_cacheTiles * _header.tileSize;
+    size_t bytes = cacheSize * cacheSize * 4u;
+    for ( const auto& level : _indirection )
+        bytes += level.size() * 4u;
+
+    return bytes;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::WorkerMain()
+{
+    for ( ;; )
+    {
+        uint64_t key = 0;
+        std::vector<unsigned char> buffer;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]() { return _quit || !_requests.empty(); });
+            if ( _quit )
+                return;
+
+            key = _requests.front();
+            _requests.pop_front();
+            if ( !_freeBuffers.empty() )
+            {
+                buffer = std::move(_freeBuffers.back());
+                _freeBuffers.pop_back();
+            }
+        }
+
+        buffer.resize(_header.GetTileBytes());
+        uint32_t mip = (uint32_t)(key >> 48), y = (uint32_t)(key >> 24) & 0xFFFFFFu, x = (uint32_t)key & 0xFFFFFFu;
+        if ( !_source->ReadTile(mip, x, y, buffer.data()) )
+            buffer.clear();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _completed.push_back({ key, std::move(buffer) });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::RequestTiles(uint32_t mip, const glm::vec2& visibleMin, const glm::vec2& visibleMax,
+                                  std::vector<uint64_t>& requests)
+{
+    float scale = 1.0f / ((float)(1u << mip) * _header.GetContentSize());
+    int maxX = (int)_header.GetTilesX(mip) - 1, maxY = (int)_header.GetTilesY(mip) - 1;
+    int x0 = std::clamp((int)std::floor(visibleMin.x * scale), 0, maxX);
+    int x1 = std::clamp((int)std::floor(visibleMax.x * scale), 0, maxX);
+    int y0 = std::clamp((int)std::floor(visibleMin.y * scale), 0, maxY);
+    int y1 = std::clamp((int)std::floor(visibleMax.y * scale), 0, maxY);
+
+    for ( int y = y0; y <= y1; ++y )
+    {
+        for ( int x = x0; x <= x1; ++x )
+        {
+            uint64_t key = MakeKey(mip, x, y);
+            auto it = _resident.find(key);
+            if ( it != _resident.end() )
+                _slots[it->second].lastUsed = _frame;
+            else if ( _pending.find(key) == _pending.end() )
+                requests.push_back(key);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::Update(const glm::vec2& visibleMin, const glm::vec2& visibleMax, float texelsPerPixel)
+{
+    ++_frame;
+
+    uint32_t topMip = _header.mipCount - 1;
+    float level = std::floor(std::log2(std::max(texelsPerPixel, 1e-6f)));
+    _requestedMip = (uint32_t)std::clamp((int)level, 0, (int)topMip);
+
+    // coarse levels first so something sensible shows up quickly
+    std::vector<uint64_t> requests;
+    for ( int mip = (int)std::min(_requestedMip + 2, topMip); mip >= (int)_requestedMip; --mip )
+        RequestTiles((uint32_t)mip, visibleMin, visibleMax, requests);
+
+    {
+        // whatever the worker has not started on is stale, replace it
+        std::lock_guard<std::mutex> lock(_mutex);
+        for ( uint64_t key : _requests )
+            _pending.erase(key);
+        _requests.clear();
+
+        for ( uint64_t key : requests )
+        {
+            if ( _pending.size() >= s_maxInFlight )
+                break;
+
+            _requests.push_back(key);
+            _pending.insert(key);
+        }
+    }
+    _wake.notify_one();
+
+    UploadCompleted();
+    UploadIndirection();
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::UploadCompleted()
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    auto start = Clock::now();
+    _uploadsLastFrame = 0;
+
+    for ( ;; )
+    {
+        Completed completed;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if ( _completed.empty() )
+                break;
+
+            completed = std::move(_completed.back());
+            _completed.pop_back();
+        }
+
+        _pending.erase(completed.key);
+        if ( !completed.pixels.empty() && Upload(completed.key, completed.pixels.data(), false) )
+            ++_uploadsLastFrame;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _freeBuffers.push_back(std::move(completed.pixels));
+        }
+
+        if ( std::chrono::duration<double, std::milli>(Clock::now() - start).count() > _uploadBudgetMs )
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+int VirtualTexture::FindVictim() const
+{
+    int victim = -1;
+    for ( int ii = 0; ii < (int)_slots.size(); ++ii )
+    {
+        const Slot& slot = _slots[ii];
+        if ( !slot.occupied )
+            return ii;
+
+        if ( slot.pinned || slot.lastUsed == _frame )
+            continue;
+
+        if ( victim < 0 || slot.lastUsed < _slots[victim].lastUsed )
+            victim = ii;
+    }
+
+    return victim;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+bool VirtualTexture::Upload(uint64_t key, const unsigned char* pixels, bool pinned)
+{
+    int index = FindVictim();
+    if ( index < 0 )
+        return false;
+
+    Slot& slot = _slots[index];
+    if ( slot.occupied )
+    {
+        UnmapTile(slot.key);
+        _resident.erase(slot.key);
+    }
+
+    unsigned int slotX = index % _cacheTiles, slotY = index / _cacheTiles;
+    glBindTexture(GL_TEXTURE_2D, _physicalID);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, slotX * _header.tileSize, slotY * _header.tileSize,
+                    _header.tileSize, _header.tileSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    slot.key      = key;
+    slot.lastUsed = _frame;
+    slot.occupied = true;
+    slot.pinned   = pinned;
+    _resident[key] = (unsigned int)index;
+
+    MapTile(key, (unsigned int)index);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::MapTile(uint64_t key, unsigned int slot)
+{
+    uint32_t mip = (uint32_t)(key >> 48), y = (uint32_t)(key >> 24) & 0xFFFFFFu, x = (uint32_t)key & 0xFFFFFFu;
+    uint32_t entry = PackEntry(slot % _cacheTiles, slot / _cacheTiles, mip);
+
+    // the tile covers a 2^(mip - level) square at every finer level, it wins
+    // wherever only a coarser tile was mapped so far
+    for ( int level = (int)mip; level >= 0; --level )
+    {
+        uint32_t shift = mip - (uint32_t)level;
+        uint32_t w = std::max(1u, _indirectionW >> level), h = std::max(1u, _indirectionH >> level);
+        uint32_t x0 = x << shift, y0 = y << shift;
+        uint32_t x1 = std::min((x + 1) << shift, w), y1 = std::min((y + 1) << shift, h);
+        std::vector<uint32_t>& texels = _indirection[level];
+
+        for ( uint32_t ty = y0; ty < y1; ++ty )
+        {
+            for ( uint32_t tx = x0; tx < x1; ++tx )
+            {
+                uint32_t& current = texels[(size_t)ty * w + tx];
+                if ( current == 0 || GetEntryMip(current) >= mip )
+                    current = entry;
+            }
+        }
+
+        MarkDirty((uint32_t)level, x0, y0, x1, y1);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::UnmapTile(uint64_t key)
+{
+    uint32_t mip = (uint32_t)(key >> 48), y = (uint32_t)(key >> 24) & 0xFFFFFFu, x = (uint32_t)key & 0xFFFFFFu;
+    unsigned int slot = _resident[key];
+    uint32_t entry = PackEntry(slot % _cacheTiles, slot / _cacheTiles, mip);
+
+    // the parent texel already points at the best coarser tile
+    uint32_t fallback = 0;
+    if ( mip + 1 < _header.mipCount )
+    {
+        uint32_t w = std::max(1u, _indirectionW >> (mip + 1));
+        fallback = _indirection[mip + 1][(size_t)(y >> 1) * w + (x >> 1)];
+    }
+
+    for ( int level = (int)mip; level >= 0; --level )
+    {
+        uint32_t shift = mip - (uint32_t)level;
+        uint32_t w = std::max(1u, _indirectionW >> level), h = std::max(1u, _indirectionH >> level);
+        uint32_t x0 = x << shift, y0 = y << shift;
+        uint32_t x1 = std::min((x + 1) << shift, w), y1 = std::min((y + 1) << shift, h);
+        std::vector<uint32_t>& texels = _indirection[level];
+
+        for ( uint32_t ty = y0; ty < y1; ++ty )
+        {
+            for ( uint32_t tx = x0; tx < x1; ++tx )
+            {
+                uint32_t& current = texels[(size_t)ty * w + tx];
+                if ( current == entry )
+                    current = fallback;
+            }
+        }
+
+        MarkDirty((uint32_t)level, x0, y0, x1, y1);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::MarkDirty(uint32_t level, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+{
+    DirtyRect& rect = _dirty[level];
+    if ( !rect.dirty )
+    {
+        rect = { x0, y0, x1, y1, true };
+        return;
+    }
+
+    rect.x0 = std::min(rect.x0, x0);
+    rect.y0 = std::min(rect.y0, y0);
+    rect.x1 = std::max(rect.x1, x1);
+    rect.y1 = std::max(rect.y1, y1);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::UploadIndirection()
+{
+    glBindTexture(GL_TEXTURE_2D, _indirectionID);
+    for ( uint32_t level = 0; level < _dirty.size(); ++level )
+    {
+        DirtyRect& rect = _dirty[level];
+        if ( !rect.dirty )
+            continue;
+
+        uint32_t w = std::max(1u, _indirectionW >> level);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, w);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, rect.x0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, rect.y0);
+        glTexSubImage2D(GL_TEXTURE_2D, level, rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0,
+                        GL_RGBA, GL_UNSIGNED_BYTE, _indirection[level].data());
+        rect.dirty = false;
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::Bind(unsigned int physicalSlot, unsigned int indirectionSlot) const
+{
+    glActiveTexture(GL_TEXTURE0 + physicalSlot);
+    glBindTexture(GL_TEXTURE_2D, _physicalID);
+    glActiveTexture(GL_TEXTURE0 + indirectionSlot);
+    glBindTexture(GL_TEXTURE_2D, _indirectionID);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+void VirtualTexture::SetUniforms(Shader& shader, unsigned int physicalSlot, unsigned int indirectionSlot) const
+{
+    shader.SetUniform1i("u_Physical", physicalSlot);
+    shader.SetUniform1i("u_Indirection", indirectionSlot);
+    shader.SetUniform2f("u_VirtualSize", (float)_header.width, (float)_header.height);
+    shader.SetUniform1f("u_TileContent", (float)_header.GetContentSize());
+    shader.SetUniform1f("u_TileSize", (float)_header.tileSize);
+    shader.SetUniform1f("u_TileBorder", (float)_header.border);
+    shader.SetUniform1f("u_CacheSize", (float)(_cacheTiles * _header.tileSize));
+    shader.SetUniform1i("u_MaxMip", (int)_header.mipCount - 1);
+}
@@ -0,0 +1,148 @@
+#ifndef _virtualtexture_h_
+#define _virtualtexture_h_
+
+#include "tilefile.h"
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Shader;
+
+// -----------------------------------------------------------------------------
+// Streams the tiles of a TileSource into a fixed size physical cache texture.
+// Visible tiles are worked out from the view each frame, read on a worker
+// thread and uploaded on the GL thread within a time budget. An indirection
+// texture with one texel per tile and level tells the shader where the best
+// resident tile for every part of the image lives.
+// -----------------------------------------------------------------------------
+class VirtualTexture
+{
+public:
+
+    VirtualTexture(std::unique_ptr<TileSource> source, unsigned int cacheTilesPerSide = 16);
+    ~VirtualTexture();
+
+    // visible region in level 0 texels and how many of them land on a pixel
+    void Update(const glm::vec2& visibleMin, const glm::vec2& visibleMax, float texelsPerPixel);
+
+    void Bind(unsigned int physicalSlot, unsigned int indirectionSlot) const;
+    void SetUniforms(Shader& shader, unsigned int physicalSlot, unsigned int indirectionSlot) const;
+
+    inline const TileFileHeader& GetHeader() const
+    {
+        return _header;
+    }
+
+    inline unsigned int GetResidentCount() const
+    {
+        return (unsigned int)_resident.size();
+    }
+
+    inline unsigned int GetCacheCapacity() const
+    {
+        return (unsigned int)_slots.size();
+    }
+
+    inline unsigned int GetPendingCount() const
+    {
+        return (unsigned int)_pending.size();
+    }
+
+    inline unsigned int GetUploadsLastFrame() const
+    {
+        return _uploadsLastFrame;
+    }
+
+    inline unsigned int GetRequestedMip() const
+    {
+        return _requestedMip;
+    }
+
+    inline void SetUploadBudget(double milliseconds)
+    {
+        _uploadBudgetMs = milliseconds;
+    }
+
+    size_t GetGpuBytes() const;
+
+private:
+
+    struct Slot
+    {
+        uint64_t        key         = 0;
+        unsigned int    lastUsed    = 0;
+        bool            occupied    = false;
+        bool            pinned      = false;
+    };
+
+    struct Completed
+    {
+        uint64_t                    key;
+        std::vector<unsigned char>  pixels;
+    };
+
+    static inline uint64_t MakeKey(uint32_t mip, uint32_t x, uint32_t y)
+    {
+        return ((uint64_t)mip << 48) | ((uint64_t)y << 24) | x;
+    }
+
+    void WorkerMain();
+    void RequestTiles(uint32_t mip, const glm::vec2& visibleMin, const glm::vec2& visibleMax,
+                      std::vector<uint64_t>& requests);
+    void UploadCompleted();
+    bool Upload(uint64_t key, const unsigned char* pixels, bool pinned);
+    int  FindVictim() const;
+    void MapTile(uint64_t key, unsigned int slot);
+    void UnmapTile(uint64_t key);
+    void MarkDirty(uint32_t level, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+    void UploadIndirection();
+
+    std::unique_ptr<TileSource>     _source;
+    TileFileHeader                  _header;
+
+    unsigned int                    _physicalID     = 0;
+    unsigned int                    _indirectionID  = 0;
+    unsigned int                    _cacheTiles     = 0;
+
+    std::vector<Slot>                       _slots;
+    std::unordered_map<uint64_t, unsigned>  _resident;     // key -> slot
+    std::unordered_set<uint64_t>            _pending;      // requested, not uploaded
+
+    // indirection levels, packed RGBA8 (slot x, slot y, mip, valid)
+    uint32_t                                _indirectionW = 0;
+    uint32_t                                _indirectionH = 0;
+    std::vector<std::vector<uint32_t>>      _indirection;
+    struct DirtyRect
+    {
+        uint32_t x0, y0, x1, y1;
+        bool dirty = false;
+    };
+    std::vector<DirtyRect>                  _dirty;
+
+    // worker communication
+    std::thread                     _worker;
+    std::mutex                      _mutex;
+    std::condition_variable         _wake;
+    std::deque<uint64_t>            _requests;
+    std::vector<Completed>          _completed;
+    std::vector<std::vector<unsigned char>> _freeBuffers;
+    bool                            _quit = false;
+
+    unsigned int                    _frame              = 0;
+    unsigned int                    _uploadsLastFrame   = 0;
+    unsigned int                    _requestedMip       = 0;
+    double                          _uploadBudgetMs     = 2.0;
+
+    static constexpr unsigned int   s_maxInFlight       = 64;
+};
+
+#endif // _virtualtexture_h_
@@ -0,0 +1,145 @@
+// Offline cooker for virtual textures: converts an image, or generates a test
+// pattern, into the tiled mip pyramid read by MappedTileFile.
+#include "tilefile.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Mip pyramid of a decoded image kept in memory while cooking.
+// -----------------------------------------------------------------------------
+class ImageTileSource : public TileSource
+{
+public:
+
+    bool Load(const std::string& path, uint32_t tileSize, uint32_t border)
+    {
+        int width = 0, height = 0, bpp = 0;
+        stbi_set_flip_vertically_on_load(1);
+        unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+        if ( !pixels )
+            return false;
+
+        _header.width    = (uint32_t)width;
+        _header.height   = (uint32_t)height;
+        _header.tileSize = tileSize;
+        _header.border   = border;
+        _header.ComputeMipCount();
+
+        _levels.resize(_header.mipCount);
+        _levels[0].assign(pixels, pixels + (size_t)width * height * 4);
+        stbi_image_free(pixels);
+
+        // 2x2 box filter down the chain
+        for ( uint32_t mip = 1; mip < _header.mipCount; ++mip )
+        {
+            uint32_t srcW = _header.GetLevelWidth(mip - 1), srcH = _header.GetLevelHeight(mip - 1);
+            uint32_t dstW = _header.GetLevelWidth(mip), dstH = _header.GetLevelHeight(mip);
+            const std::vector<unsigned char>& src = _levels[mip - 1];
+            std::vector<unsigned char>& dst = _levels[mip];
+            dst.resize((size_t)dstW * dstH * 4);
+
+            for ( uint32_t y = 0; y < dstH; ++y )
+            {
+                uint32_t y0 = std::min(2 * y, srcH - 1), y1 = std::min(2 * y + 1, srcH - 1);
+                for ( uint32_t x = 0; x < dstW; ++x )
+                {
+                    uint32_t x0 = std::min(2 * x, srcW - 1), x1 = std::min(2 * x + 1, srcW - 1);
+                    for ( int c = 0; c < 4; ++c )
+                    {
+                        unsigned int sum = src[((size_t)y0 * srcW + x0) * 4 + c] + src[((size_t)y0 * srcW + x1) * 4 + c] +
+                                           src[((size_t)y1 * srcW + x0) * 4 + c] + src[((size_t)y1 * srcW + x1) * 4 + c];
+                        dst[((size_t)y * dstW + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    const TileFileHeader& GetHeader() const override
+    {
+        return _header;
+    }
+
+    bool ReadTile(uint32_t mip, uint32_t x, uint32_t y, unsigned char* rgba) const override
+    {
+        const int content = (int)_header.GetContentSize();
+        const int border  = (int)_header.border;
+        const int size    = (int)_header.tileSize;
+        const int levelW  = (int)_header.GetLevelWidth(mip);
+        const int levelH  = (int)_header.GetLevelHeight(mip);
+        const std::vector<unsigned char>& level = _levels[mip];
+
+        for ( int py = 0; py < size; ++py )
+        {
+            int ly = std::min(std::max((int)y * content + py - border, 0), levelH - 1);
+            for ( int px = 0; px < size; ++px )
+            {
+                int lx = std::min(std::max((int)x * content + px - border, 0), levelW - 1);
+                std::memcpy(rgba + ((size_t)py * size + px) * 4, &level[((size_t)ly * levelW + lx) * 4], 4);
+            }
+        }
+
+        return true;
+    }
+
+private:
+
+    TileFileHeader                          _header;
+    std::vector<std::vector<unsigned char>> _levels;
+};
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+static void PrintUsage()
+{
+    std::cout << "usage: vtcook <image> <output.vt> [tileSize] [border]\n"
+              << "       vtcook --procedural <width> <height> <output.vt>\n";
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if ( argc >= 5 && std::strcmp(argv[1], "--procedural") == 0 )
+    {
+        ProceduralTileSource source((uint32_t)std::atoi(argv[2]), (uint32_t)std::atoi(argv[3]));
+        const TileFileHeader& header = source.GetHeader();
+        std::cout << "Cooking " << header.width << "x" << header.height << " test pattern, "
+                  << header.mipCount << " levels\n";
+        return WriteTileFile(argv[4], source) ? 0 : 1;
+    }
+
+    if ( argc < 3 )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    uint32_t tileSize = argc > 3 ? (uint32_t)std::atoi(argv[3]) : 128;
+    uint32_t border   = argc > 4 ? (uint32_t)std::atoi(argv[4]) : 4;
+    if ( tileSize > TileFileHeader::MaxTileSize || tileSize <= 2 * border )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    ImageTileSource source;
+    if ( !source.Load(argv[1], tileSize, border) )
+    {
+        std::cout << "Failed to load " << argv[1] << "\n";
+        return 1;
+    }
+
+    const TileFileHeader& header = source.GetHeader();
+    std::cout << "Cooking " << argv[1] << " " << header.width << "x" << header.height << ", "
+              << header.mipCount << " levels\n";
+    return WriteTileFile(argv[2], source) ? 0 : 1;
+}